@@ -0,0 +1,818 @@
+#include <stddef.h>
+#include <string.h>
+
+#include <retro_inline.h>
+
+/* SSE2 is part of every x86-64 target, so is used
+ * whenever the compiler allows it. The NEON functions
+ * are opt-in (-DFRAME_BLEND_ENABLE_NEON) until they
+ * have been verified against the scalar ones on ARM */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FRAME_BLEND_SIMD
+#define FRAME_BLEND_SSE2
+#elif defined(FRAME_BLEND_ENABLE_NEON) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define FRAME_BLEND_SIMD
+#define FRAME_BLEND_NEON
+#endif
+
+#include <libretro.h>
+
+#include "frame_blend.h"
+
+/* RGB565 copy of the last palette seen by a 16 bit
+ * function, rebuilt whenever the palette changes */
+static const uint32_t *currentPalette32 = NULL;
+static uint16_t currentPalette16[256]   = {0};
+
+
+/* It would be more flexible to have 'persistence'
+ * as a core option, but using a variable parameter
+ * reduces performance by ~15%. We therefore offer
+ * fixed values, and use macros to avoid excessive
+ * duplication of code...
+ * Note: persistence fraction is (persistence/128),
+ * using a power of 2 like this further increases
+ * performance by ~15% */
+#define BLEND_FRAMES_GHOST_16(persistence)                                                         \
+{                                                                                                  \
+   const uint32_t *palette32 = stella_palette;                                                     \
+   uint16_t *palette16       = currentPalette16;                                                   \
+   const uint8_t *in         = stella_fb;                                                          \
+   uint16_t *prev            = (uint16_t*)frame_buf_prev;                                          \
+   uint16_t *out             = (uint16_t*)frame_buf;                                               \
+   int i;                                                                                          \
+                                                                                                   \
+   /* If palette has changed, re-cache converted                                                   \
+    * RGB565 values */                                                                             \
+   if (palette32 != currentPalette32)                                                              \
+   {                                                                                               \
+      currentPalette32 = palette32;                                                                \
+      convert_palette(palette32, palette16);                                                       \
+   }                                                                                               \
+                                                                                                   \
+   for (i = 0; i < width * height; i++)                                                            \
+   {                                                                                               \
+      /* Get colours from current + previous frames */                                             \
+      uint16_t color_curr = *(palette16 + *(in + i));                                              \
+      uint16_t color_prev = *(prev + i);                                                           \
+                                                                                                   \
+      /* Unpack colours */                                                                         \
+      uint16_t r_curr     = (color_curr >> 11) & 0x1F;                                             \
+      uint16_t g_curr     = (color_curr >>  6) & 0x1F;                                             \
+      uint16_t b_curr     = (color_curr      ) & 0x1F;                                             \
+                                                                                                   \
+      uint16_t r_prev     = (color_prev >> 11) & 0x1F;                                             \
+      uint16_t g_prev     = (color_prev >>  6) & 0x1F;                                             \
+      uint16_t b_prev     = (color_prev      ) & 0x1F;                                             \
+                                                                                                   \
+      /* Mix colors */                                                                             \
+      uint16_t r_mix      = ((r_curr * (128 - persistence)) >> 7) + ((r_prev * persistence) >> 7); \
+      uint16_t g_mix      = ((g_curr * (128 - persistence)) >> 7) + ((g_prev * persistence) >> 7); \
+      uint16_t b_mix      = ((b_curr * (128 - persistence)) >> 7) + ((b_prev * persistence) >> 7); \
+                                                                                                   \
+      /* Output colour is the maximum of the input                                                 \
+       * and decayed values */                                                                     \
+      uint16_t r_out      = (r_mix > r_curr) ? r_mix : r_curr;                                     \
+      uint16_t g_out      = (g_mix > g_curr) ? g_mix : g_curr;                                     \
+      uint16_t b_out      = (b_mix > b_curr) ? b_mix : b_curr;                                     \
+      uint16_t color_out  = r_out << 11 | g_out << 6 | b_out;                                      \
+                                                                                                   \
+      /* Assign colour and store for next frame */                                                 \
+      *(out++)            = color_out;                                                             \
+      *(prev + i)         = color_out;                                                             \
+   }                                                                                               \
+}
+
+#define BLEND_FRAMES_GHOST_32(persistence)                                                         \
+{                                                                                                  \
+   const uint32_t *palette = stella_palette;                                                       \
+   const uint8_t *in       = stella_fb;                                                            \
+   uint32_t *prev          = (uint32_t*)frame_buf_prev;                                            \
+   uint32_t *out           = (uint32_t*)frame_buf;                                                 \
+   int i;                                                                                          \
+                                                                                                   \
+   for (i = 0; i < width * height; i++)                                                            \
+   {                                                                                               \
+      /* Get colours from current + previous frames */                                             \
+      uint32_t color_curr = *(palette + *(in + i));                                                \
+      uint32_t color_prev = *(prev + i);                                                           \
+                                                                                                   \
+      /* Unpack colours */                                                                         \
+      uint32_t r_curr     = (color_curr >> 16) & 0xFF;                                             \
+      uint32_t g_curr     = (color_curr >>  8) & 0xFF;                                             \
+      uint32_t b_curr     = (color_curr      ) & 0xFF;                                             \
+                                                                                                   \
+      uint32_t r_prev     = (color_prev >> 16) & 0xFF;                                             \
+      uint32_t g_prev     = (color_prev >>  8) & 0xFF;                                             \
+      uint32_t b_prev     = (color_prev      ) & 0xFF;                                             \
+                                                                                                   \
+      /* Mix colors */                                                                             \
+      uint32_t r_mix      = ((r_curr * (128 - persistence)) >> 7) + ((r_prev * persistence) >> 7); \
+      uint32_t g_mix      = ((g_curr * (128 - persistence)) >> 7) + ((g_prev * persistence) >> 7); \
+      uint32_t b_mix      = ((b_curr * (128 - persistence)) >> 7) + ((b_prev * persistence) >> 7); \
+                                                                                                   \
+      /* Output colour is the maximum of the input                                                 \
+       * and decayed values */                                                                     \
+      uint32_t r_out      = (r_mix > r_curr) ? r_mix : r_curr;                                     \
+      uint32_t g_out      = (g_mix > g_curr) ? g_mix : g_curr;                                     \
+      uint32_t b_out      = (b_mix > b_curr) ? b_mix : b_curr;                                     \
+      uint32_t color_out  = r_out << 16 | g_out << 8 | b_out;                                      \
+                                                                                                   \
+      /* Assign colour and store for next frame */                                                 \
+      *(out++)            = color_out;                                                             \
+      *(prev + i)         = color_out;                                                             \
+   }                                                                                               \
+}
+
+static void convert_palette(const uint32_t *palette32, uint16_t *palette16)
+{
+   size_t i;
+   for (i = 0; i < 256; i++)
+   {
+      uint32_t color32 = *(palette32 + i);
+      *(palette16 + i) = ((color32 & 0xF80000) >> 8) |
+                         ((color32 & 0x00F800) >> 5) |
+                         ((color32 & 0x0000F8) >> 3);
+   }
+}
+
+static void blend_frames_null_16(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   const uint32_t *palette32 = stella_palette;
+   uint16_t *palette16       = currentPalette16;
+   const uint8_t *in         = stella_fb;
+   uint16_t *out             = (uint16_t*)frame_buf;
+   int i;
+
+   /* If palette has changed, re-cache converted
+    * RGB565 values */
+   if (palette32 != currentPalette32)
+   {
+      currentPalette32 = palette32;
+      convert_palette(palette32, palette16);
+   }
+
+   for (i = 0; i < width * height; i++)
+      *(out++) = *(palette16 + *(in++));
+}
+
+static void blend_frames_null_32(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   const uint32_t *palette = stella_palette;
+   const uint8_t *in       = stella_fb;
+   uint32_t *out           = (uint32_t*)frame_buf;
+   int i;
+
+   for (i = 0; i < width * height; i++)
+      *(out++) = *(palette + *(in++));
+}
+
+static void blend_frames_mix_16(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   const uint32_t *palette32 = stella_palette;
+   uint16_t *palette16       = currentPalette16;
+   const uint8_t *in         = stella_fb;
+   uint16_t *prev            = (uint16_t*)frame_buf_prev;
+   uint16_t *out             = (uint16_t*)frame_buf;
+   int i;
+
+   /* If palette has changed, re-cache converted
+    * RGB565 values */
+   if (palette32 != currentPalette32)
+   {
+      currentPalette32 = palette32;
+      convert_palette(palette32, palette16);
+   }
+
+   for (i = 0; i < width * height; i++)
+   {
+      /* Get colours from current + previous frames */
+      uint16_t color_curr = *(palette16 + *(in + i));
+      uint16_t color_prev = *(prev + i);
+
+      /* Store colours for next frame */
+      *(prev + i) = color_curr;
+
+      /* Mix colours */
+      *(out++) = (color_curr + color_prev + ((color_curr ^ color_prev) & 0x821)) >> 1;
+   }
+}
+
+static void blend_frames_mix_32(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   const uint32_t *palette = stella_palette;
+   const uint8_t *in       = stella_fb;
+   uint32_t *prev          = (uint32_t*)frame_buf_prev;
+   uint32_t *out           = (uint32_t*)frame_buf;
+   int i;
+
+   for (i = 0; i < width * height; i++)
+   {
+      /* Get colours from current + previous frames */
+      uint32_t color_curr = *(palette + *(in + i));
+      uint32_t color_prev = *(prev + i);
+
+      /* Store colours for next frame */
+      *(prev + i) = color_curr;
+
+      /* Mix colours */
+      *(out++) = (color_curr + color_prev + ((color_curr ^ color_prev) & 0x1010101)) >> 1;
+   }
+}
+
+static void blend_frames_ghost65_16(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   /* 65% = 83 / 128 */
+   BLEND_FRAMES_GHOST_16(83);
+}
+
+static void blend_frames_ghost65_32(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   BLEND_FRAMES_GHOST_32(83);
+}
+
+static void blend_frames_ghost75_16(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   /* 75% = 95 / 128 */
+   BLEND_FRAMES_GHOST_16(95);
+}
+
+static void blend_frames_ghost75_32(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   BLEND_FRAMES_GHOST_32(95);
+}
+
+static void blend_frames_ghost85_16(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   /* 85% ~= 109 / 128 */
+   BLEND_FRAMES_GHOST_16(109);
+}
+
+static void blend_frames_ghost85_32(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   BLEND_FRAMES_GHOST_32(109);
+}
+
+static void blend_frames_ghost95_16(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   /* 95% ~= 122 / 128 */
+   BLEND_FRAMES_GHOST_16(122);
+}
+
+static void blend_frames_ghost95_32(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   BLEND_FRAMES_GHOST_32(122);
+}
+
+/* SIMD variants of the above. Pixels are processed in
+ * blocks of 16: Atari frames consist mostly of long runs
+ * of a single colour, so rather than attempting a palette
+ * gather we check whether all indices in a block are equal
+ * and, if so, broadcast the colour with vector stores.
+ * Mixed blocks fall back to scalar lookups into a small
+ * staging buffer. Blending itself is fully vectorised, and
+ * produces results identical to the scalar functions */
+#if defined(FRAME_BLEND_SIMD)
+
+#define SIMD_BLOCK 16
+
+#if defined(FRAME_BLEND_SSE2)
+
+static INLINE bool simd_block_uniform(const uint8_t *in)
+{
+   __m128i idx = _mm_loadu_si128((const __m128i*)in);
+   __m128i ref = _mm_set1_epi8((char)*in);
+   return _mm_movemask_epi8(_mm_cmpeq_epi8(idx, ref)) == 0xFFFF;
+}
+
+static INLINE void simd_fill_16(uint16_t *out, uint16_t color)
+{
+   __m128i c = _mm_set1_epi16((short)color);
+   _mm_storeu_si128((__m128i*)out,       c);
+   _mm_storeu_si128((__m128i*)(out + 8), c);
+}
+
+static INLINE void simd_fill_32(uint32_t *out, uint32_t color)
+{
+   __m128i c = _mm_set1_epi32((int)color);
+   _mm_storeu_si128((__m128i*)out,        c);
+   _mm_storeu_si128((__m128i*)(out + 4),  c);
+   _mm_storeu_si128((__m128i*)(out + 8),  c);
+   _mm_storeu_si128((__m128i*)(out + 12), c);
+}
+
+/* 8 pixels: out = (curr + prev) / 2, rounding down
+ * per RGB565 channel */
+static INLINE void simd_mix_16(const uint16_t *curr, const uint16_t *prev, uint16_t *out)
+{
+   __m128i c = _mm_loadu_si128((const __m128i*)curr);
+   __m128i p = _mm_loadu_si128((const __m128i*)prev);
+   __m128i h = _mm_and_si128(_mm_srli_epi16(_mm_xor_si128(c, p), 1),
+         _mm_set1_epi16((short)0xFBEF));
+   _mm_storeu_si128((__m128i*)out, _mm_sub_epi16(_mm_or_si128(c, p), h));
+}
+
+/* 4 pixels: out = (curr + prev + 1) / 2 per byte */
+static INLINE void simd_mix_32(const uint32_t *curr, const uint32_t *prev, uint32_t *out)
+{
+   __m128i c = _mm_loadu_si128((const __m128i*)curr);
+   __m128i p = _mm_loadu_si128((const __m128i*)prev);
+   _mm_storeu_si128((__m128i*)out, _mm_avg_epu8(c, p));
+}
+
+static INLINE __m128i simd_ghost_channel(__m128i c, __m128i p, __m128i wc, __m128i wp)
+{
+   __m128i mix = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(c, wc), 7),
+                               _mm_srli_epi16(_mm_mullo_epi16(p, wp), 7));
+   return _mm_max_epi16(mix, c);
+}
+
+/* 8 pixels: result is written to both 'out' and 'prev' */
+static INLINE void simd_ghost_16(const uint16_t *curr, uint16_t *prev, uint16_t *out,
+      int persistence)
+{
+   const __m128i m5 = _mm_set1_epi16(0x1F);
+   const __m128i wc = _mm_set1_epi16((short)(128 - persistence));
+   const __m128i wp = _mm_set1_epi16((short)persistence);
+   __m128i c        = _mm_loadu_si128((const __m128i*)curr);
+   __m128i p        = _mm_loadu_si128((const __m128i*)prev);
+
+   __m128i r = simd_ghost_channel(_mm_srli_epi16(c, 11),
+                                  _mm_srli_epi16(p, 11), wc, wp);
+   __m128i g = simd_ghost_channel(_mm_and_si128(_mm_srli_epi16(c, 6), m5),
+                                  _mm_and_si128(_mm_srli_epi16(p, 6), m5), wc, wp);
+   __m128i b = simd_ghost_channel(_mm_and_si128(c, m5),
+                                  _mm_and_si128(p, m5), wc, wp);
+
+   __m128i o = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 11),
+                                         _mm_slli_epi16(g, 6)), b);
+   _mm_storeu_si128((__m128i*)out,  o);
+   _mm_storeu_si128((__m128i*)prev, o);
+}
+
+/* 4 pixels: result is written to both 'out' and 'prev' */
+static INLINE void simd_ghost_32(const uint32_t *curr, uint32_t *prev, uint32_t *out,
+      int persistence)
+{
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i wc   = _mm_set1_epi16((short)(128 - persistence));
+   const __m128i wp   = _mm_set1_epi16((short)persistence);
+   __m128i c          = _mm_loadu_si128((const __m128i*)curr);
+   __m128i p          = _mm_loadu_si128((const __m128i*)prev);
+
+   __m128i lo = simd_ghost_channel(_mm_unpacklo_epi8(c, zero),
+                                   _mm_unpacklo_epi8(p, zero), wc, wp);
+   __m128i hi = simd_ghost_channel(_mm_unpackhi_epi8(c, zero),
+                                   _mm_unpackhi_epi8(p, zero), wc, wp);
+
+   __m128i o  = _mm_and_si128(_mm_packus_epi16(lo, hi), _mm_set1_epi32(0x00FFFFFF));
+   _mm_storeu_si128((__m128i*)out,  o);
+   _mm_storeu_si128((__m128i*)prev, o);
+}
+
+#elif defined(FRAME_BLEND_NEON)
+
+static INLINE bool simd_block_uniform(const uint8_t *in)
+{
+   uint8x16_t eq = vceqq_u8(vld1q_u8(in), vdupq_n_u8(*in));
+   uint8x8_t all = vand_u8(vget_low_u8(eq), vget_high_u8(eq));
+   return vget_lane_u64(vreinterpret_u64_u8(all), 0) == ~(uint64_t)0;
+}
+
+static INLINE void simd_fill_16(uint16_t *out, uint16_t color)
+{
+   uint16x8_t c = vdupq_n_u16(color);
+   vst1q_u16(out,     c);
+   vst1q_u16(out + 8, c);
+}
+
+static INLINE void simd_fill_32(uint32_t *out, uint32_t color)
+{
+   uint32x4_t c = vdupq_n_u32(color);
+   vst1q_u32(out,      c);
+   vst1q_u32(out + 4,  c);
+   vst1q_u32(out + 8,  c);
+   vst1q_u32(out + 12, c);
+}
+
+/* 8 pixels: out = (curr + prev) / 2, rounding down
+ * per RGB565 channel */
+static INLINE void simd_mix_16(const uint16_t *curr, const uint16_t *prev, uint16_t *out)
+{
+   uint16x8_t c = vld1q_u16(curr);
+   uint16x8_t p = vld1q_u16(prev);
+   uint16x8_t h = vandq_u16(vshrq_n_u16(veorq_u16(c, p), 1), vdupq_n_u16(0xFBEF));
+   vst1q_u16(out, vsubq_u16(vorrq_u16(c, p), h));
+}
+
+/* 4 pixels: out = (curr + prev + 1) / 2 per byte */
+static INLINE void simd_mix_32(const uint32_t *curr, const uint32_t *prev, uint32_t *out)
+{
+   uint8x16_t c = vreinterpretq_u8_u32(vld1q_u32(curr));
+   uint8x16_t p = vreinterpretq_u8_u32(vld1q_u32(prev));
+   vst1q_u32(out, vreinterpretq_u32_u8(vrhaddq_u8(c, p)));
+}
+
+static INLINE uint16x8_t simd_ghost_channel(uint16x8_t c, uint16x8_t p,
+      uint16x8_t wc, uint16x8_t wp)
+{
+   uint16x8_t mix = vaddq_u16(vshrq_n_u16(vmulq_u16(c, wc), 7),
+                              vshrq_n_u16(vmulq_u16(p, wp), 7));
+   return vmaxq_u16(mix, c);
+}
+
+/* 8 pixels: result is written to both 'out' and 'prev' */
+static INLINE void simd_ghost_16(const uint16_t *curr, uint16_t *prev, uint16_t *out,
+      int persistence)
+{
+   const uint16x8_t m5 = vdupq_n_u16(0x1F);
+   const uint16x8_t wc = vdupq_n_u16((uint16_t)(128 - persistence));
+   const uint16x8_t wp = vdupq_n_u16((uint16_t)persistence);
+   uint16x8_t c        = vld1q_u16(curr);
+   uint16x8_t p        = vld1q_u16(prev);
+
+   uint16x8_t r = simd_ghost_channel(vshrq_n_u16(c, 11),
+                                     vshrq_n_u16(p, 11), wc, wp);
+   uint16x8_t g = simd_ghost_channel(vandq_u16(vshrq_n_u16(c, 6), m5),
+                                     vandq_u16(vshrq_n_u16(p, 6), m5), wc, wp);
+   uint16x8_t b = simd_ghost_channel(vandq_u16(c, m5),
+                                     vandq_u16(p, m5), wc, wp);
+
+   uint16x8_t o = vorrq_u16(vorrq_u16(vshlq_n_u16(r, 11), vshlq_n_u16(g, 6)), b);
+   vst1q_u16(out,  o);
+   vst1q_u16(prev, o);
+}
+
+/* 4 pixels: result is written to both 'out' and 'prev' */
+static INLINE void simd_ghost_32(const uint32_t *curr, uint32_t *prev, uint32_t *out,
+      int persistence)
+{
+   const uint16x8_t wc = vdupq_n_u16((uint16_t)(128 - persistence));
+   const uint16x8_t wp = vdupq_n_u16((uint16_t)persistence);
+   uint8x16_t c        = vreinterpretq_u8_u32(vld1q_u32(curr));
+   uint8x16_t p        = vreinterpretq_u8_u32(vld1q_u32(prev));
+
+   uint16x8_t lo = simd_ghost_channel(vmovl_u8(vget_low_u8(c)),
+                                      vmovl_u8(vget_low_u8(p)), wc, wp);
+   uint16x8_t hi = simd_ghost_channel(vmovl_u8(vget_high_u8(c)),
+                                      vmovl_u8(vget_high_u8(p)), wc, wp);
+
+   uint32x4_t o  = vandq_u32(
+         vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(lo), vmovn_u16(hi))),
+         vdupq_n_u32(0x00FFFFFF));
+   vst1q_u32(out,  o);
+   vst1q_u32(prev, o);
+}
+
+#endif
+
+/* Expands SIMD_BLOCK palette indices into 'out' */
+static INLINE void simd_expand_16(const uint8_t *in, const uint16_t *palette, uint16_t *out)
+{
+   int j;
+
+   if (simd_block_uniform(in))
+      simd_fill_16(out, *(palette + *in));
+   else
+      for (j = 0; j < SIMD_BLOCK; j++)
+         *(out + j) = *(palette + *(in + j));
+}
+
+static INLINE void simd_expand_32(const uint8_t *in, const uint32_t *palette, uint32_t *out)
+{
+   int j;
+
+   if (simd_block_uniform(in))
+      simd_fill_32(out, *(palette + *in));
+   else
+      for (j = 0; j < SIMD_BLOCK; j++)
+         *(out + j) = *(palette + *(in + j));
+}
+
+/* Blends SIMD_BLOCK pixels. A persistence of zero
+ * selects simple mixing, otherwise ghosting is applied.
+ * Persistence is a constant at every call site, so
+ * the unused path is discarded by the compiler */
+static INLINE void simd_blend_block_16(const uint8_t *in, const uint16_t *palette,
+      uint16_t *prev, uint16_t *out, int persistence)
+{
+   uint16_t curr[SIMD_BLOCK];
+   int j;
+
+   simd_expand_16(in, palette, curr);
+
+   for (j = 0; j < SIMD_BLOCK; j += 8)
+   {
+      if (persistence)
+         simd_ghost_16(curr + j, prev + j, out + j, persistence);
+      else
+         simd_mix_16(curr + j, prev + j, out + j);
+   }
+
+   if (!persistence)
+      memcpy(prev, curr, sizeof(curr));
+}
+
+static INLINE void simd_blend_block_32(const uint8_t *in, const uint32_t *palette,
+      uint32_t *prev, uint32_t *out, int persistence)
+{
+   uint32_t curr[SIMD_BLOCK];
+   int j;
+
+   simd_expand_32(in, palette, curr);
+
+   for (j = 0; j < SIMD_BLOCK; j += 4)
+   {
+      if (persistence)
+         simd_ghost_32(curr + j, prev + j, out + j, persistence);
+      else
+         simd_mix_32(curr + j, prev + j, out + j);
+   }
+
+   if (!persistence)
+      memcpy(prev, curr, sizeof(curr));
+}
+
+/* Frame width is normally 160, so the pixel count is
+ * a multiple of SIMD_BLOCK. Should that not be the case,
+ * the trailing pixels are staged through a padded block */
+#define SIMD_BLEND_FRAME(pixel_t, palette, block_fn, persistence)              \
+{                                                                              \
+   const uint8_t *in = stella_fb;                                              \
+   pixel_t *prev     = (pixel_t*)frame_buf_prev;                               \
+   pixel_t *out      = (pixel_t*)frame_buf;                                    \
+   int size          = width * height;                                         \
+   int i;                                                                      \
+                                                                               \
+   for (i = 0; i + SIMD_BLOCK <= size; i += SIMD_BLOCK)                        \
+      block_fn(in + i, palette, prev + i, out + i, persistence);               \
+                                                                               \
+   if (i < size)                                                               \
+   {                                                                           \
+      uint8_t in_tail[SIMD_BLOCK]     = {0};                                   \
+      pixel_t prev_tail[SIMD_BLOCK] = {0};                                     \
+      pixel_t out_tail[SIMD_BLOCK];                                            \
+      size_t tail                   = size - i;                                \
+                                                                               \
+      memcpy(in_tail, in + i, tail);                                           \
+      memcpy(prev_tail, prev + i, tail * sizeof(pixel_t));                     \
+      block_fn(in_tail, palette, prev_tail, out_tail, persistence);            \
+      memcpy(out + i, out_tail, tail * sizeof(pixel_t));                       \
+      memcpy(prev + i, prev_tail, tail * sizeof(pixel_t));                     \
+   }                                                                           \
+}
+
+static INLINE void simd_blend_frame_16(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height,
+      int persistence)
+{
+   const uint32_t *palette32 = stella_palette;
+
+   /* If palette has changed, re-cache converted
+    * RGB565 values */
+   if (palette32 != currentPalette32)
+   {
+      currentPalette32 = palette32;
+      convert_palette(palette32, currentPalette16);
+   }
+
+   SIMD_BLEND_FRAME(uint16_t, currentPalette16, simd_blend_block_16, persistence);
+}
+
+static INLINE void simd_blend_frame_32(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height,
+      int persistence)
+{
+   const uint32_t *palette = stella_palette;
+
+   SIMD_BLEND_FRAME(uint32_t, palette, simd_blend_block_32, persistence);
+}
+
+/* Without blending, testing blocks for uniformity only
+ * pays off at 16 bit when most of the frame is flat
+ * colour: on busy frames a plain lookup is faster. A
+ * sample of the blocks (every SIMD_PROBE_STRIDE'th) is
+ * therefore tested first, and the scalar function used
+ * unless at least 5/8 of them are uniform. At 32 bit,
+ * and when blending, the vectorised path is no slower
+ * on any content, so is always taken */
+#define SIMD_PROBE_STRIDE 8
+
+static INLINE bool simd_frame_uniform(const uint8_t *in, int size)
+{
+   int probed  = 0;
+   int uniform = 0;
+   int i;
+
+   for (i = 0; i + SIMD_BLOCK <= size; i += SIMD_BLOCK * SIMD_PROBE_STRIDE)
+   {
+      probed++;
+      if (simd_block_uniform(in + i))
+         uniform++;
+   }
+
+   return (uniform * 8 >= probed * 5);
+}
+
+static void blend_frames_null_16_simd(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   const uint32_t *palette32 = stella_palette;
+   uint16_t *palette16       = currentPalette16;
+   const uint8_t *in         = stella_fb;
+   uint16_t *out             = (uint16_t*)frame_buf;
+   int size                  = width * height;
+   int i;
+
+   if (!simd_frame_uniform(in, size))
+   {
+      blend_frames_null_16(stella_fb, stella_palette, frame_buf, frame_buf_prev,
+            width, height);
+      return;
+   }
+
+   if (palette32 != currentPalette32)
+   {
+      currentPalette32 = palette32;
+      convert_palette(palette32, palette16);
+   }
+
+   for (i = 0; i + SIMD_BLOCK <= size; i += SIMD_BLOCK)
+      simd_expand_16(in + i, palette16, out + i);
+
+   for (; i < size; i++)
+      *(out + i) = *(palette16 + *(in + i));
+}
+
+static void blend_frames_null_32_simd(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   const uint32_t *palette = stella_palette;
+   const uint8_t *in       = stella_fb;
+   uint32_t *out           = (uint32_t*)frame_buf;
+   int size                = width * height;
+   int i;
+
+   for (i = 0; i + SIMD_BLOCK <= size; i += SIMD_BLOCK)
+      simd_expand_32(in + i, palette, out + i);
+
+   for (; i < size; i++)
+      *(out + i) = *(palette + *(in + i));
+}
+
+static void blend_frames_mix_16_simd(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   simd_blend_frame_16(stella_fb, stella_palette, frame_buf, frame_buf_prev,
+         width, height, 0);
+}
+
+static void blend_frames_mix_32_simd(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   simd_blend_frame_32(stella_fb, stella_palette, frame_buf, frame_buf_prev,
+         width, height, 0);
+}
+
+static void blend_frames_ghost65_16_simd(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   simd_blend_frame_16(stella_fb, stella_palette, frame_buf, frame_buf_prev,
+         width, height, 83);
+}
+
+static void blend_frames_ghost65_32_simd(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   simd_blend_frame_32(stella_fb, stella_palette, frame_buf, frame_buf_prev,
+         width, height, 83);
+}
+
+static void blend_frames_ghost75_16_simd(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   simd_blend_frame_16(stella_fb, stella_palette, frame_buf, frame_buf_prev,
+         width, height, 95);
+}
+
+static void blend_frames_ghost75_32_simd(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   simd_blend_frame_32(stella_fb, stella_palette, frame_buf, frame_buf_prev,
+         width, height, 95);
+}
+
+static void blend_frames_ghost85_16_simd(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   simd_blend_frame_16(stella_fb, stella_palette, frame_buf, frame_buf_prev,
+         width, height, 109);
+}
+
+static void blend_frames_ghost85_32_simd(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   simd_blend_frame_32(stella_fb, stella_palette, frame_buf, frame_buf_prev,
+         width, height, 109);
+}
+
+static void blend_frames_ghost95_16_simd(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   simd_blend_frame_16(stella_fb, stella_palette, frame_buf, frame_buf_prev,
+         width, height, 122);
+}
+
+static void blend_frames_ghost95_32_simd(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height)
+{
+   simd_blend_frame_32(stella_fb, stella_palette, frame_buf, frame_buf_prev,
+         width, height, 122);
+}
+
+#endif /* FRAME_BLEND_SIMD */
+
+/* Function tables, indexed by frame_blend_method */
+static const frame_blend_t blend_frames_16[] = {
+   blend_frames_null_16,
+   blend_frames_mix_16,
+   blend_frames_ghost65_16,
+   blend_frames_ghost75_16,
+   blend_frames_ghost85_16,
+   blend_frames_ghost95_16
+};
+
+static const frame_blend_t blend_frames_32[] = {
+   blend_frames_null_32,
+   blend_frames_mix_32,
+   blend_frames_ghost65_32,
+   blend_frames_ghost75_32,
+   blend_frames_ghost85_32,
+   blend_frames_ghost95_32
+};
+
+#if defined(FRAME_BLEND_SIMD)
+static const frame_blend_t blend_frames_16_simd[] = {
+   blend_frames_null_16_simd,
+   blend_frames_mix_16_simd,
+   blend_frames_ghost65_16_simd,
+   blend_frames_ghost75_16_simd,
+   blend_frames_ghost85_16_simd,
+   blend_frames_ghost95_16_simd
+};
+
+static const frame_blend_t blend_frames_32_simd[] = {
+   blend_frames_null_32_simd,
+   blend_frames_mix_32_simd,
+   blend_frames_ghost65_32_simd,
+   blend_frames_ghost75_32_simd,
+   blend_frames_ghost85_32_simd,
+   blend_frames_ghost95_32_simd
+};
+#endif
+
+uint64_t frame_blend_simd_flag(void)
+{
+#if defined(FRAME_BLEND_SSE2)
+   return RETRO_SIMD_SSE2;
+#elif defined(FRAME_BLEND_NEON)
+   return RETRO_SIMD_NEON;
+#else
+   return 0;
+#endif
+}
+
+frame_blend_t frame_blend_get(enum frame_blend_method method,
+      unsigned pixel_bytes, bool simd)
+{
+   if (method < FRAME_BLEND_NONE || method > FRAME_BLEND_GHOST_95)
+      method = FRAME_BLEND_NONE;
+
+#if defined(FRAME_BLEND_SIMD)
+   if (simd)
+      return (pixel_bytes == 2) ?
+            blend_frames_16_simd[method] : blend_frames_32_simd[method];
+#endif
+
+   return (pixel_bytes == 2) ?
+         blend_frames_16[method] : blend_frames_32[method];
+}
+
+void frame_blend_reset(void)
+{
+   currentPalette32 = NULL;
+}
@@ -0,0 +1,46 @@
+#ifndef FRAME_BLEND_H__
+#define FRAME_BLEND_H__
+
+#include <stdint.h>
+
+#include <boolean.h>
+
+/************************************
+ * Interframe blending
+ ************************************/
+
+enum frame_blend_method
+{
+   FRAME_BLEND_NONE = 0,
+   FRAME_BLEND_MIX,
+   FRAME_BLEND_GHOST_65,
+   FRAME_BLEND_GHOST_75,
+   FRAME_BLEND_GHOST_85,
+   FRAME_BLEND_GHOST_95
+};
+
+/* Converts the palette indices in 'stella_fb' into
+ * 'frame_buf' (RGB565 or XRGB8888), blending with the
+ * contents of 'frame_buf_prev' where the method requires
+ * it. 'frame_buf_prev' must be zeroed before the first
+ * call, and is ignored by FRAME_BLEND_NONE */
+typedef void (*frame_blend_t)(const uint8_t *stella_fb, const uint32_t *stella_palette,
+      uint8_t *frame_buf, uint8_t *frame_buf_prev, int width, int height);
+
+/* Returns the RETRO_SIMD_* flag that the host CPU must
+ * report for vectorised functions to be used, or 0 if
+ * this build has none */
+uint64_t frame_blend_simd_flag(void);
+
+/* Returns the blending function for 'method' writing
+ * 'pixel_bytes' (2 or 4) per pixel. The vectorised
+ * variant is returned if 'simd' is set and the build
+ * provides one; both produce identical output */
+frame_blend_t frame_blend_get(enum frame_blend_method method,
+      unsigned pixel_bytes, bool simd);
+
+/* Drops the cached RGB565 palette, so that it is
+ * rebuilt on the next 16 bit blend */
+void frame_blend_reset(void);
+
+#endif
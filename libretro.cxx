@@ -6,20 +6,28 @@
 #include <math.h>
 
 #include <boolean.h>
-
 #ifdef _MSC_VER
 #define snprintf _snprintf
 #endif
 
+#if defined(STELLA_THREADS)
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
 #include <libretro.h>
 #include <streams/file_stream.h>
 #include "libretro_core_options.h"
+#include "frame_blend.h"
 
 #include "Console.hxx"
 #include "Cart.hxx"
 #include "Props.hxx"
 #include "MD5.hxx"
 #include "Sound.hxx"
+#include "Resampler.hxx"
 #include "SerialPort.hxx"
 #include "TIA.hxx"
 #include "Switches.hxx"
@@ -49,8 +57,6 @@ static int videoWidth, videoHeight;
 static uint8_t *frameBuffer = NULL;
 static uint8_t *frameBufferPrev = NULL;
 static uint8_t framePixelBytes = 2;
-static const uint32_t *currentPalette32 = NULL;
-static uint16_t currentPalette16[256] = {0};
 
 #define MAX_RETROPAD_DEVICES 2
 
@@ -88,6 +94,7 @@ static struct retro_input_descriptor retropad_inputs_gamepad0_gamepad1[] = {
    { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_R3,     "Black/White" },
    { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_SELECT, "Select" },
    { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_START,  "Reset" },
+   { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_X,      "Rewind" },
    { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_Y,      "Paddle Fire" },
    { 0, RETRO_DEVICE_ANALOG, RETRO_DEVICE_INDEX_ANALOG_LEFT, RETRO_DEVICE_ID_ANALOG_X, "Paddle Analog" },
 
@@ -116,6 +123,7 @@ static struct retro_input_descriptor retropad_inputs_gamepad0_paddles1[] = {
    { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_R3,     "Black/White" },
    { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_SELECT, "Select" },
    { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_START,  "Reset" },
+   { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_X,      "Rewind" },
    { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_Y,      "Paddle Fire" },
    { 0, RETRO_DEVICE_ANALOG, RETRO_DEVICE_INDEX_ANALOG_LEFT, RETRO_DEVICE_ID_ANALOG_X, "Paddle Analog" },
 
@@ -138,6 +146,7 @@ static struct retro_input_descriptor retropad_inputs_paddles0_gamepad1[] = {
    { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_R3,     "Black/White" },
    { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_SELECT, "Select" },
    { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_START,  "Reset" },
+   { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_X,      "Rewind" },
    { 0, RETRO_DEVICE_ANALOG, RETRO_DEVICE_INDEX_ANALOG_LEFT, RETRO_DEVICE_ID_ANALOG_X, "P1 Wheel" },
    { 0, RETRO_DEVICE_ANALOG, RETRO_DEVICE_INDEX_ANALOG_LEFT, RETRO_DEVICE_ID_ANALOG_Y, "P2 Wheel" },
 
@@ -163,6 +172,7 @@ static struct retro_input_descriptor retropad_inputs_paddles0_paddles1[] = {
    { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_R3,     "Black/White" },
    { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_SELECT, "Select" },
    { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_START,  "Reset" },
+   { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_X,      "Rewind" },
    { 0, RETRO_DEVICE_ANALOG, RETRO_DEVICE_INDEX_ANALOG_LEFT, RETRO_DEVICE_ID_ANALOG_X, "P1 Wheel" },
    { 0, RETRO_DEVICE_ANALOG, RETRO_DEVICE_INDEX_ANALOG_LEFT, RETRO_DEVICE_ID_ANALOG_Y, "P2 Wheel" },
 
@@ -212,6 +222,12 @@ static int32_t low_pass_range      = 0;
 static int32_t low_pass_left_prev  = 0;
 static int32_t low_pass_right_prev = 0;
 
+/* Audio output rate, and the resampler
+ * used when it isn't the native TIA rate */
+#define TIA_SAMPLE_RATE 31400
+static uint32_t audio_sample_rate = TIA_SAMPLE_RATE;
+static Resampler resampler;
+
 static retro_log_printf_t log_cb;
 static retro_video_refresh_t video_cb;
 static retro_input_poll_t input_poll_cb;
@@ -221,267 +237,31 @@ static retro_audio_sample_t audio_cb;
 static retro_audio_sample_batch_t audio_batch_cb;
 
 static bool libretro_supports_bitmasks = false;
+static bool libretro_supports_simd     = false;
 
-/************************************
- * Interframe blending
- ************************************/
-
-enum frame_blend_method
-{
-   FRAME_BLEND_NONE = 0,
-   FRAME_BLEND_MIX,
-   FRAME_BLEND_GHOST_65,
-   FRAME_BLEND_GHOST_75,
-   FRAME_BLEND_GHOST_85,
-   FRAME_BLEND_GHOST_95
-};
-
-/* It would be more flexible to have 'persistence'
- * as a core option, but using a variable parameter
- * reduces performance by ~15%. We therefore offer
- * fixed values, and use macros to avoid excessive
- * duplication of code...
- * Note: persistence fraction is (persistence/128),
- * using a power of 2 like this further increases
- * performance by ~15% */
-#define BLEND_FRAMES_GHOST_16(persistence)                                                         \
-{                                                                                                  \
-   const uint32_t *palette32 = console->getPalette(0);                                             \
-   uint16_t *palette16       = currentPalette16;                                                   \
-   uInt8 *in                 = stella_fb;                                                          \
-   uint16_t *prev            = (uint16_t*)frameBufferPrev;                                         \
-   uint16_t *out             = (uint16_t*)frameBuffer;                                             \
-   int i;                                                                                          \
-                                                                                                   \
-   /* If palette has changed, re-cache converted                                                   \
-    * RGB565 values */                                                                             \
-   if (palette32 != currentPalette32)                                                              \
-   {                                                                                               \
-      currentPalette32 = palette32;                                                                \
-      convert_palette(palette32, palette16);                                                       \
-   }                                                                                               \
-                                                                                                   \
-   for (i = 0; i < width * height; i++)                                                            \
-   {                                                                                               \
-      /* Get colours from current + previous frames */                                             \
-      uint16_t color_curr = *(palette16 + *(in + i));                                              \
-      uint16_t color_prev = *(prev + i);                                                           \
-                                                                                                   \
-      /* Unpack colours */                                                                         \
-      uint16_t r_curr     = (color_curr >> 11) & 0x1F;                                             \
-      uint16_t g_curr     = (color_curr >>  6) & 0x1F;                                             \
-      uint16_t b_curr     = (color_curr      ) & 0x1F;                                             \
-                                                                                                   \
-      uint16_t r_prev     = (color_prev >> 11) & 0x1F;                                             \
-      uint16_t g_prev     = (color_prev >>  6) & 0x1F;                                             \
-      uint16_t b_prev     = (color_prev      ) & 0x1F;                                             \
-                                                                                                   \
-      /* Mix colors */                                                                             \
-      uint16_t r_mix      = ((r_curr * (128 - persistence)) >> 7) + ((r_prev * persistence) >> 7); \
-      uint16_t g_mix      = ((g_curr * (128 - persistence)) >> 7) + ((g_prev * persistence) >> 7); \
-      uint16_t b_mix      = ((b_curr * (128 - persistence)) >> 7) + ((b_prev * persistence) >> 7); \
-                                                                                                   \
-      /* Output colour is the maximum of the input                                                 \
-       * and decayed values */                                                                     \
-      uint16_t r_out      = (r_mix > r_curr) ? r_mix : r_curr;                                     \
-      uint16_t g_out      = (g_mix > g_curr) ? g_mix : g_curr;                                     \
-      uint16_t b_out      = (b_mix > b_curr) ? b_mix : b_curr;                                     \
-      uint16_t color_out  = r_out << 11 | g_out << 6 | b_out;                                      \
-                                                                                                   \
-      /* Assign colour and store for next frame */                                                 \
-      *(out++)            = color_out;                                                             \
-      *(prev + i)         = color_out;                                                             \
-   }                                                                                               \
-}
-
-#define BLEND_FRAMES_GHOST_32(persistence)                                                         \
-{                                                                                                  \
-   const uint32_t *palette = console->getPalette(0);                                               \
-   uInt8 *in               = stella_fb;                                                            \
-   uint32_t *prev          = (uint32_t*)frameBufferPrev;                                           \
-   uint32_t *out           = (uint32_t*)frameBuffer;                                               \
-   int i;                                                                                          \
-                                                                                                   \
-   for (i = 0; i < width * height; i++)                                                            \
-   {                                                                                               \
-      /* Get colours from current + previous frames */                                             \
-      uint32_t color_curr = *(palette + *(in + i));                                                \
-      uint32_t color_prev = *(prev + i);                                                           \
-                                                                                                   \
-      /* Unpack colours */                                                                         \
-      uint32_t r_curr     = (color_curr >> 16) & 0xFF;                                             \
-      uint32_t g_curr     = (color_curr >>  8) & 0xFF;                                             \
-      uint32_t b_curr     = (color_curr      ) & 0xFF;                                             \
-                                                                                                   \
-      uint32_t r_prev     = (color_prev >> 16) & 0xFF;                                             \
-      uint32_t g_prev     = (color_prev >>  8) & 0xFF;                                             \
-      uint32_t b_prev     = (color_prev      ) & 0xFF;                                             \
-                                                                                                   \
-      /* Mix colors */                                                                             \
-      uint32_t r_mix      = ((r_curr * (128 - persistence)) >> 7) + ((r_prev * persistence) >> 7); \
-      uint32_t g_mix      = ((g_curr * (128 - persistence)) >> 7) + ((g_prev * persistence) >> 7); \
-      uint32_t b_mix      = ((b_curr * (128 - persistence)) >> 7) + ((b_prev * persistence) >> 7); \
-                                                                                                   \
-      /* Output colour is the maximum of the input                                                 \
-       * and decayed values */                                                                     \
-      uint32_t r_out      = (r_mix > r_curr) ? r_mix : r_curr;                                     \
-      uint32_t g_out      = (g_mix > g_curr) ? g_mix : g_curr;                                     \
-      uint32_t b_out      = (b_mix > b_curr) ? b_mix : b_curr;                                     \
-      uint32_t color_out  = r_out << 16 | g_out << 8 | b_out;                                      \
-                                                                                                   \
-      /* Assign colour and store for next frame */                                                 \
-      *(out++)            = color_out;                                                             \
-      *(prev + i)         = color_out;                                                             \
-   }                                                                                               \
-}
-
-static void convert_palette(const uint32_t *palette32, uint16_t *palette16)
-{
-   size_t i;
-   for (i = 0; i < 256; i++)
-   {
-      uint32_t color32 = *(palette32 + i);
-      *(palette16 + i) = ((color32 & 0xF80000) >> 8) |
-                         ((color32 & 0x00F800) >> 5) |
-                         ((color32 & 0x0000F8) >> 3);
-   }
-}
-
-static void blend_frames_null_16(uInt8 *stella_fb, int width, int height)
-{
-   const uint32_t *palette32 = console->getPalette(0);
-   uint16_t *palette16       = currentPalette16;
-   uInt8 *in                 = stella_fb;
-   uint16_t *out             = (uint16_t*)frameBuffer;
-   int i;
-
-   /* If palette has changed, re-cache converted
-    * RGB565 values */
-   if (palette32 != currentPalette32)
-   {
-      currentPalette32 = palette32;
-      convert_palette(palette32, palette16);
-   }
-
-   for (i = 0; i < width * height; i++)
-      *(out++) = *(palette16 + *(in++));
-}
-
-static void blend_frames_null_32(uInt8 *stella_fb, int width, int height)
-{
-   const uint32_t *palette = console->getPalette(0);
-   uInt8 *in               = stella_fb;
-   uint32_t *out           = (uint32_t*)frameBuffer;
-   int i;
-
-   for (i = 0; i < width * height; i++)
-      *(out++) = *(palette + *(in++));
-}
-
-static void blend_frames_mix_16(uInt8 *stella_fb, int width, int height)
-{
-   const uint32_t *palette32 = console->getPalette(0);
-   uint16_t *palette16       = currentPalette16;
-   uInt8 *in                 = stella_fb;
-   uint16_t *prev            = (uint16_t*)frameBufferPrev;
-   uint16_t *out             = (uint16_t*)frameBuffer;
-   int i;
-
-   /* If palette has changed, re-cache converted
-    * RGB565 values */
-   if (palette32 != currentPalette32)
-   {
-      currentPalette32 = palette32;
-      convert_palette(palette32, palette16);
-   }
-
-   for (i = 0; i < width * height; i++)
-   {
-      /* Get colours from current + previous frames */
-      uint16_t color_curr = *(palette16 + *(in + i));
-      uint16_t color_prev = *(prev + i);
-
-      /* Store colours for next frame */
-      *(prev + i) = color_curr;
-
-      /* Mix colours */
-      *(out++) = (color_curr + color_prev + ((color_curr ^ color_prev) & 0x821)) >> 1;
-   }
-}
-
-static void blend_frames_mix_32(uInt8 *stella_fb, int width, int height)
-{
-   const uint32_t *palette = console->getPalette(0);
-   uInt8 *in               = stella_fb;
-   uint32_t *prev          = (uint32_t*)frameBufferPrev;
-   uint32_t *out           = (uint32_t*)frameBuffer;
-   int i;
-
-   for (i = 0; i < width * height; i++)
-   {
-      /* Get colours from current + previous frames */
-      uint32_t color_curr = *(palette + *(in + i));
-      uint32_t color_prev = *(prev + i);
-
-      /* Store colours for next frame */
-      *(prev + i) = color_curr;
-
-      /* Mix colours */
-      *(out++) = (color_curr + color_prev + ((color_curr ^ color_prev) & 0x1010101)) >> 1;
-   }
-}
-
-static void blend_frames_ghost65_16(uInt8 *stella_fb, int width, int height)
-{
-   /* 65% = 83 / 128 */
-   BLEND_FRAMES_GHOST_16(83);
-}
-
-static void blend_frames_ghost65_32(uInt8 *stella_fb, int width, int height)
-{
-   BLEND_FRAMES_GHOST_32(83);
-}
+/* Cached result of retro_serialize_size() */
+static size_t serialize_size = 0;
 
-static void blend_frames_ghost75_16(uInt8 *stella_fb, int width, int height)
-{
-   /* 75% = 95 / 128 */
-   BLEND_FRAMES_GHOST_16(95);
-}
+/* Set while the rewind button is held */
+static bool rewind_requested = false;
 
-static void blend_frames_ghost75_32(uInt8 *stella_fb, int width, int height)
-{
-   BLEND_FRAMES_GHOST_32(95);
-}
+/* Emulate frames on a worker thread */
+static bool threaded_emulation = false;
 
-static void blend_frames_ghost85_16(uInt8 *stella_fb, int width, int height)
-{
-   /* 85% ~= 109 / 128 */
-   BLEND_FRAMES_GHOST_16(109);
-}
-
-static void blend_frames_ghost85_32(uInt8 *stella_fb, int width, int height)
-{
-   BLEND_FRAMES_GHOST_32(109);
-}
-
-static void blend_frames_ghost95_16(uInt8 *stella_fb, int width, int height)
-{
-   /* 95% ~= 122 / 128 */
-   BLEND_FRAMES_GHOST_16(122);
-}
-
-static void blend_frames_ghost95_32(uInt8 *stella_fb, int width, int height)
-{
-   BLEND_FRAMES_GHOST_32(122);
-}
+/************************************
+ * Interframe blending
+ ************************************/
 
-static void (*blend_frames_16)(uInt8 *stella_fb, int width, int height) = blend_frames_null_16;
-static void (*blend_frames_32)(uInt8 *stella_fb, int width, int height) = blend_frames_null_32;
+static frame_blend_t blend_frames_16 = NULL;
+static frame_blend_t blend_frames_32 = NULL;
+static bool frame_blending            = false;
 
 static void init_frame_blending(enum frame_blend_method blend_method)
 {
+   frame_blending = (blend_method != FRAME_BLEND_NONE);
+
    /* Allocate/zero out buffer, if required */
-   if (blend_method != FRAME_BLEND_NONE)
+   if (frame_blending)
    {
       if (!frameBufferPrev)
 #ifdef _3DS
@@ -493,33 +273,8 @@ static void init_frame_blending(enum frame_blend_method blend_method)
    }
 
    /* Assign function pointers */
-   switch (blend_method)
-   {
-      case FRAME_BLEND_MIX:
-         blend_frames_16 = blend_frames_mix_16;
-         blend_frames_32 = blend_frames_mix_32;
-         break;
-      case FRAME_BLEND_GHOST_65:
-         blend_frames_16 = blend_frames_ghost65_16;
-         blend_frames_32 = blend_frames_ghost65_32;
-         break;
-      case FRAME_BLEND_GHOST_75:
-         blend_frames_16 = blend_frames_ghost75_16;
-         blend_frames_32 = blend_frames_ghost75_32;
-         break;
-      case FRAME_BLEND_GHOST_85:
-         blend_frames_16 = blend_frames_ghost85_16;
-         blend_frames_32 = blend_frames_ghost85_32;
-         break;
-      case FRAME_BLEND_GHOST_95:
-         blend_frames_16 = blend_frames_ghost95_16;
-         blend_frames_32 = blend_frames_ghost95_32;
-         break;
-      default:
-         blend_frames_16 = blend_frames_null_16;
-         blend_frames_32 = blend_frames_null_32;
-         break;
-   }
+   blend_frames_16 = frame_blend_get(blend_method, 2, libretro_supports_simd);
+   blend_frames_32 = frame_blend_get(blend_method, 4, libretro_supports_simd);
 }
 
 /************************************
@@ -665,6 +420,14 @@ static void init_paddles(void)
    }
 }
 
+static void update_controllers()
+{
+   /* Tell all input devices to read their state from the event structure */
+   console->controller(Controller::Left).update();
+   console->controller(Controller::Right).update();
+   console->switches().update();
+}
+
 static void update_input()
 {
    unsigned i;
@@ -690,6 +453,9 @@ static void update_input()
             joy_bits |= input_state_cb(i, RETRO_DEVICE_JOYPAD, 0, j) ? (1 << j) : 0;
       }
 
+      if (i == 0)
+         rewind_requested = joy_bits & (1 << RETRO_DEVICE_ID_JOYPAD_X);
+
       if (retropad_devices[i] == RETROPAD_STELLA_PADDLES)
       {
          /* Handle paddle devices */
@@ -825,10 +591,7 @@ static void update_input()
       }
    }
 
-   /* Tell all input devices to read their state from the event structure */
-   console->controller(Controller::Left).update();
-   console->controller(Controller::Right).update();
-   console->switches().update();
+   update_controllers();
 }
 
 static void check_variables(bool first_run)
@@ -838,6 +601,8 @@ static void check_variables(bool first_run)
    int last_paddle_sensitivity;
    int stelladaptor_sensitivity;
    int stelladaptor_center;
+   uint32_t last_sample_rate;
+   uInt32 rewind_buffer_size;
 
    /* Only read colour depth option on first run */
    if (first_run)
@@ -853,6 +618,21 @@ static void check_variables(bool first_run)
             framePixelBytes = 4;
    }
 
+#if defined(STELLA_THREADS)
+   /* Only read threaded emulation option on first run */
+   if (first_run)
+   {
+      var.key   = "stella2014_threaded_emulation";
+      var.value = NULL;
+
+      threaded_emulation = false;
+
+      if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+         if (strcmp(var.value, "enabled") == 0)
+            threaded_emulation = true;
+   }
+#endif
+
    /* Read interframe blending option */
    var.key   = "stella2014_mix_frames";
    var.value = NULL;
@@ -891,6 +671,30 @@ static void check_variables(bool first_run)
    if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
       low_pass_range = (strtol(var.value, NULL, 10) * 0x10000) / 100;
 
+   /* Read audio output rate option */
+   var.key   = "stella2014_audio_sample_rate";
+   var.value = NULL;
+
+   last_sample_rate  = audio_sample_rate;
+   audio_sample_rate = TIA_SAMPLE_RATE;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      audio_sample_rate = (uint32_t)strtoul(var.value, NULL, 10);
+
+   if (first_run || (audio_sample_rate != last_sample_rate))
+   {
+      resampler.setRates(TIA_SAMPLE_RATE, audio_sample_rate);
+
+      /* The frontend has to be told about
+       * rate changes while a game is running */
+      if (!first_run)
+      {
+         struct retro_system_av_info av_info;
+         retro_get_system_av_info(&av_info);
+         environ_cb(RETRO_ENVIRONMENT_SET_SYSTEM_AV_INFO, &av_info);
+      }
+   }
+
    /* Read paddle digital sensitivity option */
    var.key   = "stella2014_paddle_digital_sensitivity";
    var.value = NULL;
@@ -974,6 +778,391 @@ static void check_variables(bool first_run)
    stelladaptor_analog_center =
          get_stelladaptor_analog_center(
                stelladaptor_center);
+
+   /* Read rewind buffer size option */
+   var.key   = "stella2014_rewind_buffer";
+   var.value = NULL;
+
+   rewind_buffer_size = 0;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      rewind_buffer_size = (uInt32)strtoul(var.value, NULL, 10) << 20;
+
+   stateManager.rewindManager().setBufferSize(rewind_buffer_size);
+}
+
+/************************************
+ * Frame emulation
+ ************************************/
+
+/* Emulates a single frame, rendering it into frameBuffer
+ * (unless video is disabled and frames aren't blended)
+ * and its audio into an
+ * internal buffer, which is returned in 'samples'.
+ * Returns the number of stereo samples */
+static uint32_t emulate_frame(bool video_enabled, bool rewinding,
+      const int16_t **samples)
+{
+   static int16_t sampleBuffer[2048];
+   static int16_t resampledBuffer[4096];
+   //Get the number of samples in a frame
+   static uint32_t tiaSamplesPerFrame = (uint32_t)((float)TIA_SAMPLE_RATE/console->getFramerate());
+
+   //Store the state the frame starts from, so that rewinding past it
+   //replays this frame
+   if (!rewinding)
+      stateManager.update();
+
+   //EMULATE
+   //Frames which won't be shown are still rendered and blended while
+   //frame blending is on, since the next frame shown is blended with
+   //them; only passing them to the frontend is skipped
+   TIA& tia = console->tia();
+   bool render = video_enabled || frame_blending;
+   tia.enableRendering(render);
+   tia.update();
+
+   //VIDEO
+   if (render)
+   {
+      //Get the frame info from stella
+      videoWidth = tia.width();
+      videoHeight = tia.height();
+
+      //Copy the frame from stella to libretro
+      if (framePixelBytes == 2)
+         blend_frames_16(tia.currentFrameBuffer(), console->getPalette(0),
+               frameBuffer, frameBufferPrev, videoWidth, videoHeight);
+      else
+         blend_frames_32(tia.currentFrameBuffer(), console->getPalette(0),
+               frameBuffer, frameBufferPrev, videoWidth, videoHeight);
+   }
+
+   //AUDIO
+   osystem.sound().processFragment(sampleBuffer, tiaSamplesPerFrame);
+
+   //Mute audio while rewinding
+   if (rewinding)
+      memset(sampleBuffer, 0, sizeof(sampleBuffer));
+
+   if (low_pass_enabled)
+      apply_low_pass_filter(sampleBuffer, tiaSamplesPerFrame);
+
+   //Convert to the output rate, if it isn't the TIA's own
+   if (resampler.enabled())
+   {
+      *samples = resampledBuffer;
+      return resampler.process(sampleBuffer, tiaSamplesPerFrame,
+            resampledBuffer, sizeof(resampledBuffer) / (2 * sizeof(int16_t)));
+   }
+
+   *samples = sampleBuffer;
+   return tiaSamplesPerFrame;
+}
+
+/* Handles everything needing the frontend before a
+ * frame is emulated: core option changes, input and
+ * rewinding. Returns whether the frame is rewound, and
+ * in 'video_enabled' whether it will be shown */
+static bool prepare_frame(bool *video_enabled)
+{
+   //CORE OPTIONS
+   bool updated = false;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE_UPDATE, &updated) && updated)
+      check_variables(false);
+
+   //INPUT
+   update_input();
+
+   //REWIND
+   //Each stored state is the one a frame started from, so the newest is
+   //that of the frame last shown; dropping it and emulating a frame from
+   //the one before shows the frame before the last one
+   bool rewinding = false;
+   if (rewind_requested && stateManager.rewindManager().rewindState())
+   {
+      //Loading the state also restored the previous frame's input
+      update_controllers();
+      rewinding = true;
+   }
+
+   //Frames the frontend won't show (fast-forward frame skip, run-ahead)
+   //are emulated without generating any pixels
+   int av_enable = 0x3;
+   if (!environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &av_enable))
+      av_enable = 0x3;
+   *video_enabled = (av_enable & 0x1) != 0;
+
+   return rewinding;
+}
+
+/************************************
+ * Threaded emulation
+ ************************************/
+
+#if defined(STELLA_THREADS)
+/* With threaded emulation, each frame is emulated on a
+ * worker thread while the frontend presents the previous
+ * one. The console is only ever touched by one thread at
+ * a time: retro_run() waits for the worker to finish a
+ * frame before polling input and starting the next one.
+ * Output is passed back without locking: video through
+ * two frame buffers used in turn, audio through a single
+ * producer/single consumer ring buffer, which retro_run()
+ * drains while the worker is busy.
+ *
+ * This adds a frame of input latency, so emulation is no
+ * longer in step with the input it would get when run on
+ * the frontend thread. Threaded emulation is therefore
+ * off by default, and stopped whenever the frontend
+ * saves or loads a state for run-ahead or netplay */
+
+/* Stereo samples held by the audio ring buffer
+ * (must be a power of 2) */
+#define AUDIO_RING_SIZE 8192
+
+static int16_t audio_ring[AUDIO_RING_SIZE * 2];
+static std::atomic<uint32_t> audio_ring_head(0);
+static std::atomic<uint32_t> audio_ring_tail(0);
+
+static std::thread emu_thread;
+static std::mutex emu_mutex;
+static std::condition_variable emu_cond;
+static bool emu_thread_running = false;
+static bool emu_busy           = false;
+static bool emu_quit           = false;
+
+/* Whether a frame has been emulated but not yet passed
+ * to the frontend; only used by the frontend thread */
+static bool emu_frame_pending = false;
+
+/* Settings of the frame being emulated */
+static bool emu_video_enabled = true;
+static bool emu_rewinding     = false;
+
+/* Frame buffers used in turn by the worker */
+static uint8_t *frameSlots[2] = { NULL, NULL };
+
+/* Producer side: adds samples to the ring buffer,
+ * dropping any which don't fit */
+static void audio_ring_write(const int16_t *samples, uint32_t count)
+{
+   uint32_t head  = audio_ring_head.load(std::memory_order_relaxed);
+   uint32_t tail  = audio_ring_tail.load(std::memory_order_acquire);
+   uint32_t space = AUDIO_RING_SIZE - (head - tail);
+   uint32_t i;
+
+   if (count > space)
+      count = space;
+
+   for (i = 0; i < count; i++)
+   {
+      uint32_t pos            = ((head + i) & (AUDIO_RING_SIZE - 1)) * 2;
+      audio_ring[pos]         = samples[i * 2];
+      audio_ring[pos + 1]     = samples[i * 2 + 1];
+   }
+
+   audio_ring_head.store(head + count, std::memory_order_release);
+}
+
+/* Consumer side: passes all samples in the ring buffer
+ * to the frontend */
+static void audio_ring_flush(void)
+{
+   uint32_t tail = audio_ring_tail.load(std::memory_order_relaxed);
+   uint32_t head = audio_ring_head.load(std::memory_order_acquire);
+
+   while (tail != head)
+   {
+      /* Stop at the end of the buffer, so that each
+       * batch is contiguous */
+      uint32_t pos   = tail & (AUDIO_RING_SIZE - 1);
+      uint32_t count = head - tail;
+
+      if (count > AUDIO_RING_SIZE - pos)
+         count = AUDIO_RING_SIZE - pos;
+
+      audio_batch_cb(audio_ring + pos * 2, count);
+      tail += count;
+   }
+
+   audio_ring_tail.store(tail, std::memory_order_release);
+}
+
+/* Consumer side: discards all samples in the ring buffer */
+static void audio_ring_clear(void)
+{
+   audio_ring_tail.store(audio_ring_head.load(std::memory_order_acquire),
+         std::memory_order_release);
+}
+
+static void emu_thread_loop(void)
+{
+   std::unique_lock<std::mutex> lock(emu_mutex);
+
+   for (;;)
+   {
+      const int16_t *samples;
+      uint32_t count;
+
+      while (!emu_busy && !emu_quit)
+         emu_cond.wait(lock);
+
+      if (emu_quit)
+         break;
+
+      lock.unlock();
+      count = emulate_frame(emu_video_enabled, emu_rewinding, &samples);
+      audio_ring_write(samples, count);
+      lock.lock();
+
+      emu_busy = false;
+      emu_cond.notify_all();
+   }
+}
+
+/* Waits for the worker to finish the frame it's emulating,
+ * if any; the console may be used freely afterwards */
+static void emu_thread_wait(void)
+{
+   std::unique_lock<std::mutex> lock(emu_mutex);
+
+   while (emu_busy)
+      emu_cond.wait(lock);
+}
+
+/* Has the worker emulate the next frame into the frame
+ * buffer which isn't being shown */
+static void emu_thread_start_frame(bool video_enabled, bool rewinding)
+{
+   std::unique_lock<std::mutex> lock(emu_mutex);
+
+   frameBuffer       = (frameBuffer == frameSlots[0]) ?
+         frameSlots[1] : frameSlots[0];
+   emu_video_enabled = video_enabled;
+   emu_rewinding     = rewinding;
+   emu_busy          = true;
+   emu_frame_pending = true;
+   emu_cond.notify_all();
+}
+
+static void emu_thread_start(void)
+{
+   if (emu_thread_running)
+      return;
+
+   frameSlots[0] = frameBuffer;
+   frameSlots[1] = (uint8_t*)malloc(FRAME_BUFFER_SIZE);
+   if (!frameSlots[1])
+      return;
+   memcpy(frameSlots[1], frameSlots[0], FRAME_BUFFER_SIZE);
+
+   emu_busy          = false;
+   emu_quit          = false;
+   emu_frame_pending = false;
+   audio_ring_clear();
+
+   emu_thread         = std::thread(emu_thread_loop);
+   emu_thread_running = true;
+}
+
+/* Stops the worker, after which frames are emulated on
+ * the frontend thread. A frame which has been emulated
+ * but not yet passed to the frontend is dropped */
+static void emu_thread_stop(void)
+{
+   if (!emu_thread_running)
+      return;
+
+   {
+      std::unique_lock<std::mutex> lock(emu_mutex);
+      while (emu_busy)
+         emu_cond.wait(lock);
+      emu_quit = true;
+      emu_cond.notify_all();
+   }
+
+   emu_thread.join();
+   emu_thread_running = false;
+   emu_frame_pending  = false;
+   audio_ring_clear();
+
+   /* Keep the buffer holding the last frame */
+   if (frameBuffer != frameSlots[0])
+   {
+      memcpy(frameSlots[0], frameBuffer, FRAME_BUFFER_SIZE);
+      frameBuffer = frameSlots[0];
+   }
+   free(frameSlots[1]);
+   frameSlots[1] = NULL;
+}
+
+static void retro_run_threaded(void)
+{
+   bool video_enabled;
+   bool rewinding;
+
+   /* Nothing has been emulated yet after loading a game
+    * or a state, so emulate the first frame right away */
+   if (!emu_frame_pending)
+   {
+      rewinding = prepare_frame(&video_enabled);
+      emu_thread_start_frame(video_enabled, rewinding);
+   }
+
+   emu_thread_wait();
+
+   /* Take the frame just emulated, then start the next
+    * one before handing it to the frontend */
+   uint8_t *frame      = frameBuffer;
+   int width           = videoWidth;
+   int height          = videoHeight;
+   bool frame_rendered = emu_video_enabled;
+
+   rewinding = prepare_frame(&video_enabled);
+   emu_thread_start_frame(video_enabled, rewinding);
+
+   /* Every call presents a frame: if the one just emulated
+    * wasn't rendered, as the frontend asked on the previous
+    * call, the last one shown is duplicated */
+   if (frame_rendered)
+      video_cb(frame, width, height, width * framePixelBytes);
+   else
+      video_cb(NULL, width, height, width * framePixelBytes);
+
+   audio_ring_flush();
+}
+#endif
+
+/* Makes sure the console isn't in use by the worker
+ * before it's accessed from the frontend thread */
+static void sync_emulation(void)
+{
+#if defined(STELLA_THREADS)
+   if (emu_thread_running)
+      emu_thread_wait();
+#endif
+}
+
+/* Drops any frame emulated ahead of the frontend, once
+ * the console's state has been replaced */
+static void discard_emulated_frame(void)
+{
+#if defined(STELLA_THREADS)
+   if (emu_thread_running)
+   {
+      emu_frame_pending = false;
+      audio_ring_clear();
+   }
+#endif
+}
+
+/* Stops threaded emulation, if it's running */
+static void stop_threaded_emulation(void)
+{
+#if defined(STELLA_THREADS)
+   emu_thread_stop();
+#endif
 }
 
 /************************************
@@ -1015,7 +1204,7 @@ void retro_get_system_av_info(struct retro_system_av_info *info)
 {
    memset(info, 0, sizeof(*info));
    info->timing.fps            = console->getFramerate();
-   info->timing.sample_rate    = 31400;
+   info->timing.sample_rate    = audio_sample_rate;
    info->geometry.base_width   = 160 * 2;
    info->geometry.base_height  = videoHeight;
    info->geometry.max_width    = 320;
@@ -1101,30 +1290,83 @@ void retro_set_controller_port_device(unsigned port, unsigned device)
 
 size_t retro_serialize_size(void) 
 {
-   Serializer state;
-   if(!stateManager.saveState(state))
-      return 0;
-   return state.get().size();
+   /* The state size is constant for a given cart,
+    * so it only needs to be measured once. This is
+    * done with a serializer which just counts bytes */
+   if (serialize_size == 0)
+   {
+      sync_emulation();
+
+      Serializer state(NULL, 0);
+      if (stateManager.saveState(state))
+         serialize_size = state.size();
+   }
+
+   return serialize_size;
+}
+
+static int savestate_context(void)
+{
+   int context = RETRO_SAVESTATE_CONTEXT_NORMAL;
+
+   if (!environ_cb(RETRO_ENVIRONMENT_GET_SAVESTATE_CONTEXT, &context))
+      return RETRO_SAVESTATE_CONTEXT_NORMAL;
+
+   return context;
 }
 
 bool retro_serialize(void *data, size_t size)
 {
-    Serializer state;
-    if(!stateManager.saveState(state))
-        return false;
-    std::string s = state.get();
-    memcpy(data, s.data(), s.size());
-    return true;
+   int context = savestate_context();
+
+   if (!console)
+      return false;
+
+   /* Run-ahead and netplay need emulation to stay in
+    * step with input */
+   if (context != RETRO_SAVESTATE_CONTEXT_NORMAL)
+      stop_threaded_emulation();
+   else
+      sync_emulation();
+
+   /* Run-ahead states are loaded back into this very
+    * instance within a few frames, so a raw snapshot of
+    * the console is enough */
+   if (context == RETRO_SAVESTATE_CONTEXT_RUNAHEAD_SAME_INSTANCE)
+      return console->saveSnapshot((uInt8*)data, (uInt32)size) != 0;
+
+   /* Write directly into the frontend's buffer. Only
+    * states which may persist beyond the current session
+    * are protected by a checksum; netplay states are
+    * short-lived, and are saved every frame */
+   Serializer state((uInt8*)data, (uInt32)size);
+   return stateManager.saveState(state,
+         context == RETRO_SAVESTATE_CONTEXT_NORMAL) && state.isValid();
 }
 
 bool retro_unserialize(const void *data, size_t size)
 {
-    std::string s((const char*)data, size);
-    Serializer state;
-    state.set(s);
-   if(stateManager.loadState(state))
+   int context = savestate_context();
+
+   if (!console)
+      return false;
+
+   if (context != RETRO_SAVESTATE_CONTEXT_NORMAL)
+      stop_threaded_emulation();
+   else
+      sync_emulation();
+
+   if (context == RETRO_SAVESTATE_CONTEXT_RUNAHEAD_SAME_INSTANCE &&
+       console->loadSnapshot((const uInt8*)data, (uInt32)size))
       return true;
-   return false;
+
+   /* Read directly from the frontend's buffer */
+   Serializer state((uInt8*)data, (uInt32)size, true);
+   if (!stateManager.loadState(state) || !state.isValid())
+      return false;
+
+   discard_emulated_frame();
+   return true;
 }
 
 void retro_cheat_reset(void)
@@ -1180,7 +1422,7 @@ bool retro_load_game(const struct retro_game_info *info)
    string cartType = props.get(Cartridge_Type);
    string cartId;//, romType("AUTO-DETECT");
    settings = new Settings(&osystem);
-   settings->setValue("romloadcount", false);
+   settings->setValue(Settings::RomLoadCount, false);
    cartridge = Cartridge::create((const uInt8*)info->data, (uInt32)info->size, cartMD5, cartType, cartId, osystem, *settings);
 
    if(cartridge == 0)
@@ -1193,6 +1435,8 @@ bool retro_load_game(const struct retro_game_info *info)
    // Create the console
    console = new Console(&osystem, cartridge, props);
    osystem.myConsole = console;
+   serialize_size = 0;
+   stateManager.reset();
 
    // Init sound and video
    console->initializeVideo();
@@ -1212,6 +1456,18 @@ bool retro_load_game(const struct retro_game_info *info)
    videoWidth = tia.width();
    videoHeight = tia.height();
 
+#if defined(STELLA_THREADS)
+   /* A frame emulated ahead with video off is presented as
+    * a duplicate of the last one, which the frontend must
+    * support */
+   if (threaded_emulation)
+   {
+      bool can_dupe = false;
+      if (environ_cb(RETRO_ENVIRONMENT_GET_CAN_DUPE, &can_dupe) && can_dupe)
+         emu_thread_start();
+   }
+#endif
+
    return true;
 }
 
@@ -1225,6 +1481,11 @@ bool retro_load_game_special(unsigned game_type, const struct retro_game_info *i
 
 void retro_unload_game(void) 
 {
+   stop_threaded_emulation();
+
+   serialize_size = 0;
+   stateManager.reset();
+
    if (console)
    {
       delete console;
@@ -1286,6 +1547,21 @@ void retro_init(void)
    if (environ_cb(RETRO_ENVIRONMENT_GET_INPUT_BITMASKS, NULL))
       libretro_supports_bitmasks = true;
 
+   /* SIMD blending is enabled whenever the build
+    * provides it, unless the frontend reports that
+    * the host CPU lacks the required features */
+   {
+      struct retro_perf_callback perf;
+      uint64_t simd_flag = frame_blend_simd_flag();
+
+      libretro_supports_simd = (simd_flag != 0);
+      memset(&perf, 0, sizeof(perf));
+      if (libretro_supports_simd &&
+          environ_cb(RETRO_ENVIRONMENT_GET_PERF_INTERFACE, &perf) &&
+          perf.get_cpu_features)
+         libretro_supports_simd = (perf.get_cpu_features() & simd_flag) != 0;
+   }
+
 #ifdef _3DS
    frameBuffer = (uint8_t*)linearMemAlign(FRAME_BUFFER_SIZE, 128);
 #else
@@ -1295,7 +1571,10 @@ void retro_init(void)
 
 void retro_deinit(void)
 {
+   stop_threaded_emulation();
+
    libretro_supports_bitmasks = false;
+   libretro_supports_simd     = false;
    left_controller_type       = Controller::Joystick;
    MouseAxisValue0            = Event::MouseAxisXValue;
    MouseButtonValue0          = Event::MouseButtonLeftValue;
@@ -1304,7 +1583,14 @@ void retro_deinit(void)
    low_pass_enabled           = false;
    low_pass_left_prev         = 0;
    low_pass_right_prev        = 0;
-   currentPalette32           = NULL;
+   audio_sample_rate          = TIA_SAMPLE_RATE;
+   rewind_requested           = false;
+   threaded_emulation         = false;
+
+   frame_blend_reset();
+
+   /* Release rewind history */
+   stateManager.rewindManager().setBufferSize(0);
 
    if (frameBuffer)
    {
@@ -1329,44 +1615,28 @@ void retro_deinit(void)
 
 void retro_reset(void)
 {
+   sync_emulation();
    console->system().reset();
 }
 
 void retro_run(void)
 {
-   static int16_t sampleBuffer[2048];
-   //Get the number of samples in a frame
-   static uint32_t tiaSamplesPerFrame = (uint32_t)(31400.0f/console->getFramerate());
-
-   //CORE OPTIONS
-   bool updated = false;
-   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE_UPDATE, &updated) && updated)
-      check_variables(false);
-
-   //INPUT
-   update_input();
-
-   //EMULATE
-   TIA& tia = console->tia();
-   tia.update();
-
-   //VIDEO
-   //Get the frame info from stella
-   videoWidth = tia.width();
-   videoHeight = tia.height();
-
-   //Copy the frame from stella to libretro
-   if (framePixelBytes == 2)
-      blend_frames_16(tia.currentFrameBuffer(), videoWidth, videoHeight);
-   else
-      blend_frames_32(tia.currentFrameBuffer(), videoWidth, videoHeight);
+#if defined(STELLA_THREADS)
+   if (emu_thread_running)
+   {
+      retro_run_threaded();
+      return;
+   }
+#endif
 
-   video_cb(frameBuffer, videoWidth, videoHeight, videoWidth * framePixelBytes);
+   bool video_enabled;
+   bool rewinding = prepare_frame(&video_enabled);
 
-   osystem.sound().processFragment(sampleBuffer, tiaSamplesPerFrame);
+   const int16_t *samples;
+   uint32_t count = emulate_frame(video_enabled, rewinding, &samples);
 
-   if (low_pass_enabled)
-      apply_low_pass_filter(sampleBuffer, tiaSamplesPerFrame);
+   if (video_enabled)
+      video_cb(frameBuffer, videoWidth, videoHeight, videoWidth * framePixelBytes);
 
-   audio_batch_cb(sampleBuffer, tiaSamplesPerFrame);
+   audio_batch_cb(samples, count);
 }
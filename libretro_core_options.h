@@ -114,6 +114,18 @@ struct retro_core_option_definition option_defs_us[] = {
       },
       "60"
    },
+   {
+      "stella2014_audio_sample_rate",
+      "Audio Output Rate",
+      "Sets the rate of the audio passed to the frontend. 'Native' outputs the TIA chip's own 31400 Hz, which the frontend has to resample. Other rates are converted in the core using band-limited synthesis, which reduces aliasing and lets the frontend skip its own resampling when the rates match.",
+      {
+         { "31400", "Native (31400 Hz)" },
+         { "44100", "44100 Hz" },
+         { "48000", "48000 Hz" },
+         { NULL, NULL },
+      },
+      "31400"
+   },
    {
       "stella2014_paddle_digital_sensitivity",
       "Gamepad: Paddle Sensitivity (Digital)",
@@ -301,6 +313,35 @@ struct retro_core_option_definition option_defs_us[] = {
       },
       "0"
    },
+   {
+      "stella2014_rewind_buffer",
+      "Rewind Buffer Size",
+      "Keeps a history of recent frames in memory, which is rewound while the RetroPad X button of port 1 is held. Larger buffers keep a longer history; how long depends on the game, from under a minute to several minutes per megabyte.",
+      {
+         { "disabled", NULL },
+         { "1",  "1 MB" },
+         { "2",  "2 MB" },
+         { "4",  "4 MB" },
+         { "8",  "8 MB" },
+         { "16", "16 MB" },
+         { "32", "32 MB" },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+#if defined(STELLA_THREADS)
+   {
+      "stella2014_threaded_emulation",
+      "Threaded Emulation",
+      "Emulates each frame on a separate thread while the frontend presents the previous one. Adds one frame of input latency. Not used with run-ahead or netplay, which switch back to regular emulation. Takes effect when a game is loaded.",
+      {
+         { "disabled", NULL },
+         { "enabled",  NULL },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+#endif
    { NULL, NULL, NULL, {{0}}, NULL },
 };
 
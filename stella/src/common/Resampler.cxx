@@ -0,0 +1,205 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include <cmath>
+#include <cstring>
+
+#include "Resampler.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Resampler::Resampler()
+  : myInputRate(0),
+    myOutputRate(0),
+    myFactor(0),
+    myMaxInput(0)
+{
+  memset(myKernel, 0, sizeof(myKernel));
+  clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Resampler::~Resampler()
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Resampler::setRates(uInt32 inputRate, uInt32 outputRate)
+{
+  myInputRate = inputRate;
+  myOutputRate = outputRate;
+
+  if(enabled())
+  {
+    myFactor = ((uInt64)outputRate << 32) / inputRate;
+
+    // Once the complete samples are read, up to kWidth + 1 are left in
+    // the buffer; make sure the output of each batch of input fits
+    myMaxInput = (uInt32)(((uInt64)(kBufferSize - 2 * kWidth) << 32) / myFactor);
+
+    buildKernel();
+  }
+  clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Resampler::clear()
+{
+  myTime = 0;
+  memset(myBuffer, 0, sizeof(myBuffer));
+  mySum[0] = mySum[1] = 0;
+  myLevel[0] = myLevel[1] = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Resampler::process(const Int16* in, uInt32 samples, Int16* out,
+                          uInt32 maxSamples)
+{
+  if(!enabled())
+  {
+    uInt32 count = samples < maxSamples ? samples : maxSamples;
+    memcpy(out, in, count * 2 * sizeof(Int16));
+    return count;
+  }
+
+  uInt32 created = 0;
+  while(samples > 0)
+  {
+    uInt32 count = samples < myMaxInput ? samples : myMaxInput;
+    for(uInt32 i = 0; i < count; ++i, in += 2)
+    {
+      // Only changes in level contribute anything to the output
+      if(in[0] != myLevel[0])
+        addStep(myTime, 0, in[0]);
+      if(in[1] != myLevel[1])
+        addStep(myTime, 1, in[1]);
+      myTime += myFactor;
+    }
+    samples -= count;
+
+    created += readSamples(out + created * 2, maxSamples - created);
+  }
+
+  return created;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Resampler::buildKernel()
+{
+  // Keep everything above 90% of the output's Nyquist frequency out of
+  // the steps, whichever way the conversion goes
+  const double PI = 3.14159265358979323846;
+  const double cutoff = 0.45;  // in cycles per output sample
+
+  for(int phase = 0; phase < kPhases; ++phase)
+  {
+    double taps[kWidth], sum = 0.0;
+    for(int i = 0; i < kWidth; ++i)
+    {
+      // Distance from the step to this tap, in output samples
+      double x = i - kWidth / 2 - (double)phase / kPhases;
+
+      double sinc = x == 0.0 ? 1.0 :
+          sin(2 * PI * cutoff * x) / (2 * PI * cutoff * x);
+      double u = x / (kWidth / 2);
+      double window = fabs(u) >= 1.0 ? 0.0 :
+          0.42 + 0.5 * cos(PI * u) + 0.08 * cos(2 * PI * u);  // Blackman
+
+      taps[i] = sinc * window;
+      sum += taps[i];
+    }
+
+    // Scale each impulse to sum to exactly 1.0, so that a step always
+    // ends up at the new level, however it's been rounded
+    Int32 total = 0, center = 0;
+    for(int i = 0; i < kWidth; ++i)
+    {
+      myKernel[phase][i] = (Int32)floor(taps[i] / sum * (1 << kKernelBits) + 0.5);
+      total += myKernel[phase][i];
+      if(myKernel[phase][i] > myKernel[phase][center])
+        center = i;
+    }
+    myKernel[phase][center] += (1 << kKernelBits) - total;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Resampler::addStep(uInt64 time, int chan, Int16 level)
+{
+  // Round to the nearest phase
+  time += (uInt64)1 << (31 - kPhaseBits);
+
+  const Int32* kernel = myKernel[(time >> (32 - kPhaseBits)) & (kPhases - 1)];
+  Int64* buffer = myBuffer[chan] + (uInt32)(time >> 32);
+  Int64 delta = level - myLevel[chan];
+
+  for(int i = 0; i < kWidth; ++i)
+    buffer[i] += delta * kernel[i];
+
+  myLevel[chan] = level;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline Int16 Resampler::clip(Int64 sum)
+{
+  Int64 sample = (sum + (1 << (kKernelBits - 1))) >> kKernelBits;
+  sample = sample > 32767 ? 32767 : sample;
+  sample = sample < -32768 ? -32768 : sample;
+
+  return (Int16)sample;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Resampler::readSamples(Int16* out, uInt32 maxSamples)
+{
+  // No step can be added before the next input sample, so every output
+  // sample before it is complete
+  uInt32 complete = (uInt32)(myTime >> 32);
+  uInt32 count = complete < maxSamples ? complete : maxSamples;
+
+  Int64* left = myBuffer[0];
+  Int64* right = myBuffer[1];
+  Int64 sumLeft = mySum[0], sumRight = mySum[1];
+  uInt32 i = 0;
+
+  for(; i < count; ++i)
+  {
+    sumLeft += left[i];
+    sumRight += right[i];
+    out[i * 2]     = clip(sumLeft);
+    out[i * 2 + 1] = clip(sumRight);
+  }
+  for(; i < complete; ++i)
+  {
+    sumLeft += left[i];
+    sumRight += right[i];
+  }
+  mySum[0] = sumLeft;
+  mySum[1] = sumRight;
+
+  // Only the first kWidth + 2 samples past the complete ones can have
+  // anything added to them so far; the rest of the buffer is still empty
+  for(int chan = 0; chan < 2; ++chan)
+  {
+    memmove(myBuffer[chan], myBuffer[chan] + complete, (kWidth + 2) * sizeof(Int64));
+    memset(myBuffer[chan] + kWidth + 2, 0, complete * sizeof(Int64));
+  }
+  myTime -= (uInt64)complete << 32;
+
+  return count;
+}
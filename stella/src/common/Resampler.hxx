@@ -0,0 +1,147 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef RESAMPLER_HXX
+#define RESAMPLER_HXX
+
+#include "bspf.hxx"
+
+/**
+  This class converts the stereo samples created by the TIA to another
+  sample rate, using band-limited synthesis.
+
+  The TIA output only changes on a sound clock, ie, on a sample boundary
+  at the native rate, so it's a series of steps rather than a waveform.
+  Each change in level is rendered into the output as a band-limited step
+  (a windowed sinc impulse, integrated), placed at its exact time within
+  the output.  This avoids the aliasing of simpler interpolating
+  resamplers, and only costs anything when the level changes.
+
+  Output samples lag the input by kWidth/2 output samples, since the
+  impulses extend into the past as well.
+
+  @version $Id$
+*/
+class Resampler
+{
+  public:
+    /**
+      Create a new resampler, which passes samples through unchanged
+      until setRates() is called
+    */
+    Resampler();
+
+    /**
+      Destructor
+    */
+    virtual ~Resampler();
+
+  public:
+    /**
+      Set the input and output sample rates.  Any pending output is
+      discarded.
+
+      @param inputRate   The rate of the samples passed to process()
+      @param outputRate  The rate of the samples it creates
+    */
+    void setRates(uInt32 inputRate, uInt32 outputRate);
+
+    /**
+      Answers whether the output rate differs from the input rate
+    */
+    bool enabled() const { return myInputRate != myOutputRate; }
+
+    /**
+      Discard any pending output, and start again from silence
+    */
+    void clear();
+
+    /**
+      Convert interleaved stereo samples to the output rate.  The number
+      of samples created varies from call to call, depending on where the
+      input starts and ends in relation to the output samples.
+
+      @param in          The samples to convert
+      @param samples     The number of stereo samples in 'in'
+      @param out         The location to store the converted samples
+      @param maxSamples  The number of stereo samples 'out' can hold; any
+                         samples beyond that are dropped
+
+      @return The number of stereo samples stored in 'out'
+    */
+    uInt32 process(const Int16* in, uInt32 samples, Int16* out,
+                   uInt32 maxSamples);
+
+  private:
+    // Copy constructor isn't supported by this class so make it private
+    Resampler(const Resampler&);
+
+    // Assignment operator isn't supported by this class so make it private
+    Resampler& operator = (const Resampler&);
+
+    // Calculate the kernel for each phase, for the current rates
+    void buildKernel();
+
+    // Add the step between the last input level and 'level' at the
+    // given time to the buffer, for the given channel
+    void addStep(uInt64 time, int chan, Int16 level);
+
+    // Convert a running sum to a sample, rounded and clipped to 16 bits
+    Int16 clip(Int64 sum);
+
+    // Move up to 'maxSamples' complete samples from the buffer to 'out',
+    // and answer the number moved
+    uInt32 readSamples(Int16* out, uInt32 maxSamples);
+
+  private:
+    enum {
+      kWidth      = 16,               // taps per impulse
+      kPhaseBits  = 6,
+      kPhases     = 1 << kPhaseBits,  // impulse positions per output sample
+      kKernelBits = 15,               // each impulse sums to 1 << kKernelBits
+      kBufferSize = 2048 + kWidth     // output samples held in the buffer
+    };
+
+    uInt32 myInputRate;
+    uInt32 myOutputRate;
+
+    // Output samples advanced per input sample, as 32.32 fixed point
+    uInt64 myFactor;
+
+    // Input samples handled at a time, so that their output fits in the
+    // buffer
+    uInt32 myMaxInput;
+
+    // Time of the next input sample, in output samples from the start of
+    // the buffer, as 32.32 fixed point
+    uInt64 myTime;
+
+    // The band-limited impulse for each phase, in 1.kKernelBits fixed point
+    Int32 myKernel[kPhases][kWidth];
+
+    // The impulses added for each channel, which are integrated to create
+    // the output, and the running sums used to do so
+    Int64 myBuffer[2][kBufferSize];
+    Int64 mySum[2];
+
+    // The level of the last input sample of each channel
+    Int16 myLevel[2];
+};
+
+#endif
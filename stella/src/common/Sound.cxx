@@ -31,7 +31,6 @@
 Sound::Sound(OSystem* osystem)
   : myIsEnabled(false),
     myIsInitializedFlag(false),
-    myLastRegisterSetCycle(0),
     myNumChannels(0),
     myIsMuted(true),
     myVolume(100)
@@ -50,7 +49,7 @@ Sound::~Sound()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Sound::setEnabled(bool state)
 {
-  myOSystem->settings().setValue("sound", state);
+  myOSystem->settings().setValue(Settings::Sound, state);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -58,7 +57,7 @@ void Sound::open()
 {
   myIsEnabled = false;
   mute(true);
-  if(!myIsInitializedFlag || !myOSystem->settings().getBool("sound"))
+  if(!myIsInitializedFlag || !myOSystem->settings().getBool(Settings::Sound))
   {
     return;
   }
@@ -68,7 +67,7 @@ void Sound::open()
   myTIASound.channels(2, myNumChannels == 2);
 
   // Adjust volume to that defined in settings
-  myVolume = myOSystem->settings().getInt("volume");
+  myVolume = myOSystem->settings().getInt(Settings::Volume);
   setVolume(myVolume);
 
   myIsEnabled = true;
@@ -81,7 +80,6 @@ void Sound::close()
   if(myIsInitializedFlag)
   {
     myIsEnabled = false;
-    myLastRegisterSetCycle = 0;
     myTIASound.reset();
     myRegWriteQueue.clear();
   }
@@ -99,7 +97,6 @@ void Sound::reset()
 {
   if(myIsInitializedFlag)
   {
-    myLastRegisterSetCycle = 0;
     myTIASound.reset();
     myRegWriteQueue.clear();
     mute(myIsMuted);
@@ -111,7 +108,7 @@ void Sound::setVolume(Int32 percent)
 {
   if(myIsInitializedFlag && (percent >= 0) && (percent <= 100))
   {
-    myOSystem->settings().setValue("volume", percent);
+    myOSystem->settings().setValue(Settings::Volume, percent);
     myVolume = percent;
     myTIASound.volume(percent);
   }
@@ -136,7 +133,14 @@ void Sound::adjustVolume(Int8 direction)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Sound::adjustCycleCounter(Int32 amount)
 {
-  myLastRegisterSetCycle += amount;
+  // Normally the queue is emptied by processFragment() at the end of
+  // each frame, so this only happens when no sound is being created
+  while(myRegWriteQueue.size() > 0)
+  {
+    RegWrite& info = myRegWriteQueue.front();
+    myTIASound.set(info.addr, info.value);
+    myRegWriteQueue.dequeue();
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -149,162 +153,52 @@ void Sound::setChannels(uInt32 channels)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Sound::set(uInt16 addr, uInt8 value, Int32 cycle)
 {
-  // First, calculate how many seconds would have past since the last
-  // register write on a real 2600
-  double delta = (((double)(cycle - myLastRegisterSetCycle)) / 
-      (1193191.66666667));
-
-  // Now, adjust the time based on the frame rate the user has selected. For
-  // the sound to "scale" correctly, we have to know the games real frame 
-  // rate (e.g., 50 or 60) and the currently emulated frame rate. We use these
-  // values to "scale" the time before the register change occurs.
   RegWrite info;
   info.addr = addr;
   info.value = value;
-  info.delta = delta;
+  info.cycle = cycle;
   myRegWriteQueue.enqueue(info);
-
-  // Update last cycle counter to the current cycle
-  myLastRegisterSetCycle = cycle;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Sound::processFragment(Int16* stream, uInt32 length)
 {
-    const uInt32 channels = 2;
-    double streamLengthInSecs = (double)length/(double)31400;
-    double excessStreamSecs = myRegWriteQueue.duration() - streamLengthInSecs;
-    if(excessStreamSecs > 0.0)
-    {
-        double removed = 0.0;
-        while(removed < excessStreamSecs)
-        {
-            RegWrite& info = myRegWriteQueue.front();
-            removed += info.delta;
-            myTIASound.set(info.addr, info.value);
-            myRegWriteQueue.dequeue();
-        }
-    }
-
-  double position = 0.0;
-  double remaining = length;
+  const uInt32 channels = 2;
+  uInt32 position = 0;
 
-  while(remaining > 0.0)
+  // The system cycle counter is reset at the start of each frame, which
+  // is where the fragment starts as well
+  while(myRegWriteQueue.size() > 0)
   {
-    if(myRegWriteQueue.size() == 0)
-    {
-      // There are no more pending TIA sound register updates so we'll
-      // use the current settings to finish filling the sound fragment
-      myTIASound.process(stream + ((uInt32)position * channels),
-          length - (uInt32)position);
-
-      // Since we had to fill the fragment we'll reset the cycle counter
-      // to zero.  NOTE: This isn't 100% correct, however, it'll do for
-      // now.  We should really remember the overrun and remove it from
-      // the delta of the next write.
-      myLastRegisterSetCycle = 0;
-      break;
-    }
-    else
-    {
-      // There are pending TIA sound register updates so we need to
-      // update the sound buffer to the point of the next register update
-      RegWrite& info = myRegWriteQueue.front();
+    RegWrite& info = myRegWriteQueue.front();
 
-      // How long will the remaining samples in the fragment take to play
-      double duration = remaining / (double)31400;
-
-      // Does the register update occur before the end of the fragment?
-      if(info.delta <= duration)
-      {
-        // If the register update time hasn't already passed then
-        // process samples upto the point where it should occur
-        if(info.delta > 0.0)
-        {
-          // Process the fragment upto the next TIA register write.  We
-          // round the count passed to process up if needed.
-          double samples = (31400 * info.delta);
-          myTIASound.process(stream + ((uInt32)position * channels),
-              (uInt32)samples + (uInt32)(position + samples) - 
-              ((uInt32)position + (uInt32)samples));
-
-          position += samples;
-          remaining -= samples;
-        }
-        myTIASound.set(info.addr, info.value);
-        myRegWriteQueue.dequeue();
-      }
-      else
+    // Process the fragment upto the first sample following the write;
+    // writes past the end of the fragment take effect in the next one
+    if(info.cycle > 0)
+    {
+      uInt32 sample = (uInt32)(((Int64)info.cycle * kTicksPerCycle +
+          kTicksPerSample - 1) / kTicksPerSample);
+      if(sample > length)
+        sample = length;
+      if(sample > position)
       {
-        // The next register update occurs in the next fragment so finish
-        // this fragment with the current TIA settings and reduce the register
-        // update delay by the corresponding amount of time
-        myTIASound.process(stream + ((uInt32)position * channels),
-            length - (uInt32)position);
-        info.delta -= duration;
-        break;
+        myTIASound.process(stream + position * channels, sample - position);
+        position = sample;
       }
     }
+    myTIASound.set(info.addr, info.value);
+    myRegWriteQueue.dequeue();
   }
-    
-//    double position = 0.0;
-//    double remaining = length;
-//    
-//    while(remaining > 0.0)
-//    {
-//        if(myRegWriteQueue.size() == 0)
-//        {
-//            // There are no more pending TIA sound register updates so we'll use the current settings to finish filling the sound fragment
-//            myTIASound.process(stream + ((uInt32)position * 2), length - (uInt32)position);
-//            myLastRegisterSetCycle = 0;
-//            break;
-//        }
-//        else
-//        {
-//            // There are pending TIA sound register updates so we need to
-//            // update the sound buffer to the point of the next register update
-//            RegWrite& info = myRegWriteQueue.front();
-//            
-//            // How long will the remaining samples in the fragment take to play
-//            //      double duration = remaining / (double)myHardwareSpec.freq;
-//            double duration = remaining / 31400.0;
-//            
-//            // Does the register update occur before the end of the fragment?
-//            if(info.delta <= duration)
-//            {
-//                // If the register update time hasn't already passed then
-//                // process samples upto the point where it should occur
-//                if(info.delta > 0.0)
-//                {
-//                    // Process the fragment upto the next TIA register write.  We
-//                    // round the count passed to process up if needed.
-//                    //          double samples = (myHardwareSpec.freq * info.delta);
-//                    double samples = (31400.0 * info.delta);
-//                    myTIASound.process(stream + ((uInt32)position * 2), (uInt32)samples + (uInt32)(position + samples) - ((uInt32)position + (uInt32)samples));
-//                    
-//                    position += samples;
-//                    remaining -= samples;
-//                }
-//                myTIASound.set(info.addr, info.value);
-//                myRegWriteQueue.dequeue();
-//            }
-//            else
-//            {
-//                // The next register update occurs in the next fragment so finish
-//                // this fragment with the current TIA settings and reduce the register
-//                // update delay by the corresponding amount of time
-//                myTIASound.process(stream + ((uInt32)position * 2), length - (uInt32)position);
-//                info.delta -= duration;
-//                break;
-//            }
-//        }
-//    }
+
+  // Finish the fragment with the current TIA settings
+  if(position < length)
+    myTIASound.process(stream + position * channels, length - position);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Sound::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
 
    uInt8 reg1 = 0, reg2 = 0, reg3 = 0, reg4 = 0, reg5 = 0, reg6 = 0;
 
@@ -326,7 +220,9 @@ bool Sound::save(Serializer& out) const
    out.putByte(reg5);
    out.putByte(reg6);
 
-   out.putInt(myLastRegisterSetCycle);
+   // Formerly the cycle of the last register write; register writes
+   // are now always processed by the end of the frame
+   out.putInt(0);
 
    return true;
 }
@@ -334,7 +230,7 @@ bool Sound::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Sound::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    uInt8 reg1 = in.getByte(),
@@ -344,7 +240,7 @@ bool Sound::load(Serializer& in)
          reg5 = in.getByte(),
          reg6 = in.getByte();
 
-   myLastRegisterSetCycle = (Int32) in.getInt();
+   in.getInt();
 
    // Only update the TIA sound registers if sound is enabled
    // Make sure to empty the queue of previous sound fragments
@@ -395,17 +291,6 @@ void Sound::RegWriteQueue::dequeue()
   }
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double Sound::RegWriteQueue::duration()
-{
-  double duration = 0.0;
-  for(uInt32 i = 0; i < mySize; ++i)
-  {
-    duration += myBuffer[(myHead + i) % myCapacity].delta;
-  }
-  return duration;
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Sound::RegWriteQueue::enqueue(const RegWrite& info)
 {
@@ -73,7 +73,7 @@ Cartridge* Cartridge::create(const uInt8* image, uInt32 size, string& md5,
   // See if we should try to auto-detect the cartridge type
   // If we ask for extended info, always do an autodetect
   string autodetect = "";
-  if(type == "AUTO" || settings.getBool("rominfo"))
+  if(type == "AUTO" || settings.getBool(Settings::RomInfo))
   {
     const string& detected = autodetectType(image, size);
     autodetect = "*";
@@ -262,7 +262,7 @@ string Cartridge::createFromMultiCart(const uInt8*& image, uInt32& size,
     uInt32 numroms, string& md5, string& id, Settings& settings)
 {
   // Get a piece of the larger image
-  uInt32 i = settings.getInt("romloadcount");
+  uInt32 i = settings.getInt(Settings::RomLoadCount);
   size /= numroms;
   image += i*size;
 
@@ -273,7 +273,7 @@ string Cartridge::createFromMultiCart(const uInt8*& image, uInt32& size,
   id = buf.str();
 
   // Move to the next game the next time this ROM is loaded
-  settings.setValue("romloadcount", (i+1)%numroms);
+  settings.setValue(Settings::RomLoadCount, (i+1)%numroms);
 
   if(size <= 2048)       return "2K";
   else if(size == 4096)  return "4K";
@@ -358,6 +358,10 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
   // Guess type based on size
   const char* type = 0;
 
+  // Most of the tests below look for byte signatures; where any are
+  // needed, they're all found with a single pass over the image
+  bool found[SIG_COUNT];
+
   if((size % 8448) == 0 || size == 6144)
   {
     type = "AR";
@@ -369,11 +373,13 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
   else if((size == 2048) ||
           (size == 4096 && memcmp(image, image + 2048, 2048) == 0))
   {
-    type = isProbablyCV(image, size) ? "CV" : "2K";
+    scanForSignatures(image, size, found);
+    type = isProbablyCV(found) ? "CV" : "2K";
   }
   else if(size == 4096)
   {
-    if(isProbablyCV(image,size))
+    scanForSignatures(image, size, found);
+    if(isProbablyCV(found))
       type = "CV";
     else if(isProbably4KSC(image,size))
       type = "4KSC";
@@ -382,25 +388,26 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
   }
   else if(size == 8*1024)  // 8K
   {
+    scanForSignatures(image, size, found);
+
     // First check for *potential* F8
-    uInt8 signature[] = { 0x8D, 0xF9, 0x1F };  // STA $1FF9
-    bool f8 = searchForBytes(image, size, signature, 3, 2);
+    bool f8 = found[SIG_F8];
 
     if(isProbablySC(image, size))
       type = "F8SC";
     else if(memcmp(image, image + 4096, 4096) == 0)
       type = "4K";
-    else if(isProbablyE0(image, size))
+    else if(isProbablyE0(found))
       type = "E0";
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(found))
       type = "3E";
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(found))
       type = "3F";
-    else if(isProbablyUA(image, size))
+    else if(isProbablyUA(found))
       type = "UA";
-    else if(isProbablyFE(image, size) && !f8)
+    else if(isProbablyFE(found) && !f8)
       type = "FE";
-    else if(isProbably0840(image, size))
+    else if(isProbably0840(found))
       type = "0840";
     else
       type = "F8";
@@ -415,14 +422,15 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
   }
   else if(size == 16*1024)  // 16K
   {
+    scanForSignatures(image, size, found);
     if(isProbablySC(image, size))
       type = "F6SC";
-    else if(isProbablyE7(image, size))
+    else if(isProbablyE7(found))
       type = "E7";
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(found))
       type = "3E";
   /* no known 16K 3F ROMS
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(found))
       type = "3F";
   */
     else
@@ -436,20 +444,21 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
   {
     if(isProbablyARM(image, size))
       type = "FA2";
-    else /*if(isProbablyDPCplus(image, size))*/
+    else /*if(isProbablyDPCplus(found))*/
       type = "DPC+";
   }
   else if(size == 32*1024)  // 32K
   {
+    scanForSignatures(image, size, found);
     if(isProbablySC(image, size))
       type = "F4SC";
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(found))
       type = "3E";
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(found))
       type = "3F";
-    else if(isProbablyDPCplus(image, size))
+    else if(isProbablyDPCplus(found))
       type = "DPC+";
-    else if(isProbablyCTY(image, size))
+    else if(isProbablyCTY(found))
       type = "CTY";
     else if(isProbablyFA2(image, size))
       type = "FA2";
@@ -458,50 +467,54 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
   }
   else if(size == 64*1024)  // 64K
   {
-    if(isProbably3E(image, size))
+    scanForSignatures(image, size, found);
+    if(isProbably3E(found))
       type = "3E";
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(found))
       type = "3F";
     else if(isProbably4A50(image, size))
       type = "4A50";
-    else if(isProbablyEF(image, size, type))
+    else if(isProbablyEF(image, size, found, type))
       ; // type has been set directly in the function
-    else if(isProbablyX07(image, size))
+    else if(isProbablyX07(found))
       type = "X07";
     else
       type = "F0";
   }
   else if(size == 128*1024)  // 128K
   {
-    if(isProbably3E(image, size))
+    scanForSignatures(image, size, found);
+    if(isProbably3E(found))
       type = "3E";
     else if(isProbablyDF(image, size, type))
       ; // type has been set directly in the function
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(found))
       type = "3F";
     else if(isProbably4A50(image, size))
       type = "4A50";
-    else if(isProbablySB(image, size))
+    else if(isProbablySB(found))
       type = "SB";
     else
       type = "MC";
   }
   else if(size == 256*1024)  // 256K
   {
-    if(isProbably3E(image, size))
+    scanForSignatures(image, size, found);
+    if(isProbably3E(found))
       type = "3E";
     else if(isProbablyBF(image, size, type))
       ; // type has been set directly in the function
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(found))
       type = "3F";
-    else /*if(isProbablySB(image, size))*/
+    else /*if(isProbablySB(found))*/
       type = "SB";
   }
   else  // what else can we do?
   {
-    if(isProbably3E(image, size))
+    scanForSignatures(image, size, found);
+    if(isProbably3E(found))
       type = "3E";
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(found))
       type = "3F";
     else
       type = "4K";  // Most common bankswitching type
@@ -538,6 +551,47 @@ bool Cartridge::searchForBytes(const uInt8* image, uInt32 imagesize,
   return (count >= minhits);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::scanForSignatures(const uInt8* image, uInt32 size, bool* found)
+{
+  // Very few positions in an image start with the first two bytes of any
+  // signature, so only those are compared against all of them
+  uInt8 filter[65536 / 8];
+  memset(filter, 0, sizeof(filter));
+  for(uInt32 k = 0; k < SIG_COUNT; ++k)
+  {
+    uInt16 pair = (ourSignatures[k].bytes[0] << 8) | ourSignatures[k].bytes[1];
+    filter[pair >> 3] |= 1 << (pair & 7);
+  }
+
+  // Hits are counted exactly as searchForBytes() would, ie, matches don't
+  // overlap (and neither do they touch) and the final position isn't used
+  uInt32 count[SIG_COUNT], next[SIG_COUNT];
+  for(uInt32 k = 0; k < SIG_COUNT; ++k)
+    count[k] = next[k] = 0;
+
+  for(uInt32 i = 0; i + 1 < size; ++i)
+  {
+    uInt16 pair = (image[i] << 8) | image[i+1];
+    if(!(filter[pair >> 3] & (1 << (pair & 7))))
+      continue;
+
+    for(uInt32 k = 0; k < SIG_COUNT; ++k)
+    {
+      const Signature& sig = ourSignatures[k];
+      if(i >= next[k] && count[k] < sig.minhits && i + sig.size < size &&
+         memcmp(image + i, sig.bytes, sig.size) == 0)
+      {
+        ++count[k];
+        next[k] = i + sig.size + 1;
+      }
+    }
+  }
+
+  for(uInt32 k = 0; k < SIG_COUNT; ++k)
+    found[k] = count[k] >= ourSignatures[k].minhits;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge::isProbablySC(const uInt8* image, uInt32 size)
 {
@@ -590,49 +644,34 @@ bool Cartridge::isProbablyARM(const uInt8* image, uInt32 size)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbably0840(const uInt8* image, uInt32 size)
+bool Cartridge::isProbably0840(const bool* found)
 {
   // 0840 cart bankswitching is triggered by accessing addresses 0x0800
   // or 0x0840 at least twice
-  uInt8 signature1[3][3] = {
-    { 0xAD, 0x00, 0x08 },  // LDA $0800
-    { 0xAD, 0x40, 0x08 },  // LDA $0840
-    { 0x2C, 0x00, 0x08 }   // BIT $0800
-  };
-  for(uInt32 i = 0; i < 3; ++i)
-    if(searchForBytes(image, size, signature1[i], 3, 2))
-      return true;
-
-  uInt8 signature2[2][4] = {
-    { 0x0C, 0x00, 0x08, 0x4C },  // NOP $0800; JMP ...
-    { 0x0C, 0xFF, 0x0F, 0x4C }   // NOP $0FFF; JMP ...
-  };
-  for(uInt32 i = 0; i < 2; ++i)
-    if(searchForBytes(image, size, signature2[i], 4, 2))
+  for(uInt32 i = 0; i < 5; ++i)
+    if(found[SIG_0840 + i])
       return true;
 
   return false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbably3E(const uInt8* image, uInt32 size)
+bool Cartridge::isProbably3E(const bool* found)
 {
   // 3E cart bankswitching is triggered by storing the bank number
   // in address 3E using 'STA $3E', commonly followed by an
   // immediate mode LDA
-  uInt8 signature[] = { 0x85, 0x3E, 0xA9, 0x00 };  // STA $3E; LDA #$00
-  return searchForBytes(image, size, signature, 4, 1);
+  return found[SIG_3E];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbably3F(const uInt8* image, uInt32 size)
+bool Cartridge::isProbably3F(const bool* found)
 {
   // 3F cart bankswitching is triggered by storing the bank number
   // in address 3F using 'STA $3F'
   // We expect it will be present at least 2 times, since there are
   // at least two banks
-  uInt8 signature[] = { 0x85, 0x3F };  // STA $3F
-  return searchForBytes(image, size, signature, 2, 2);
+  return found[SIG_3F];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -654,87 +693,58 @@ bool Cartridge::isProbably4A50(const uInt8* image, uInt32 size)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyCTY(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyCTY(const bool* found)
 {
   return false;  // TODO - add autodetection
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyCV(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyCV(const bool* found)
 {
   // CV RAM access occurs at addresses $f3ff and $f400
-  // These signatures are attributed to the MESS project
-  uInt8 signature[2][3] = {
-    { 0x9D, 0xFF, 0xF3 },  // STA $F3FF.X
-    { 0x99, 0x00, 0xF4 }   // STA $F400.Y
-  };
-  if(searchForBytes(image, size, signature[0], 3, 1))
-    return true;
-  else
-    return searchForBytes(image, size, signature[1], 3, 1);
+  return found[SIG_CV] || found[SIG_CV + 1];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyDPCplus(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyDPCplus(const bool* found)
 {
   // DPC+ ARM code has 2 occurrences of the string DPC+
-  uInt8 signature[] = { 'D', 'P', 'C', '+' };
-  return searchForBytes(image, size, signature, 4, 2);
+  return found[SIG_DPCPLUS];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyE0(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyE0(const bool* found)
 {
   // E0 cart bankswitching is triggered by accessing addresses
   // $FE0 to $FF9 using absolute non-indexed addressing
   // To eliminate false positives (and speed up processing), we
   // search for only certain known signatures
   // Thanks to "stella@casperkitty.com" for this advice
-  // These signatures are attributed to the MESS project
-  uInt8 signature[8][3] = {
-   { 0x8D, 0xE0, 0x1F },  // STA $1FE0
-   { 0x8D, 0xE0, 0x5F },  // STA $5FE0
-   { 0x8D, 0xE9, 0xFF },  // STA $FFE9
-   { 0x0C, 0xE0, 0x1F },  // NOP $1FE0
-   { 0xAD, 0xE0, 0x1F },  // LDA $1FE0
-   { 0xAD, 0xE9, 0xFF },  // LDA $FFE9
-   { 0xAD, 0xED, 0xFF },  // LDA $FFED
-   { 0xAD, 0xF3, 0xBF }   // LDA $BFF3
-  };
   for(uInt32 i = 0; i < 8; ++i)
-    if(searchForBytes(image, size, signature[i], 3, 1))
+    if(found[SIG_E0 + i])
       return true;
 
   return false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyE7(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyE7(const bool* found)
 {
   // E7 cart bankswitching is triggered by accessing addresses
   // $FE0 to $FE6 using absolute non-indexed addressing
   // To eliminate false positives (and speed up processing), we
   // search for only certain known signatures
   // Thanks to "stella@casperkitty.com" for this advice
-  // These signatures are attributed to the MESS project
-  uInt8 signature[7][3] = {
-   { 0xAD, 0xE2, 0xFF },  // LDA $FFE2
-   { 0xAD, 0xE5, 0xFF },  // LDA $FFE5
-   { 0xAD, 0xE5, 0x1F },  // LDA $1FE5
-   { 0xAD, 0xE7, 0x1F },  // LDA $1FE7
-   { 0x0C, 0xE7, 0x1F },  // NOP $1FE7
-   { 0x8D, 0xE7, 0xFF },  // STA $FFE7
-   { 0x8D, 0xE7, 0x1F }   // STA $1FE7
-  };
   for(uInt32 i = 0; i < 7; ++i)
-    if(searchForBytes(image, size, signature[i], 3, 1))
+    if(found[SIG_E7 + i])
       return true;
 
   return false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyEF(const uInt8* image, uInt32 size, const char*& type)
+bool Cartridge::isProbablyEF(const uInt8* image, uInt32 size,
+                             const bool* found, const char*& type)
 {
   // Newer EF carts store strings 'EFEF' and 'EFSC' starting at address $FFF8
   // This signature is attributed to "RevEng" of AtariAge
@@ -755,15 +765,9 @@ bool Cartridge::isProbablyEF(const uInt8* image, uInt32 size, const char*& type)
   // 0xFE0 to 0xFEF, usually with either a NOP or LDA
   // It's likely that the code will switch to bank 0, so that's what is tested
   bool isEF = false;
-  uInt8 signature[4][3] = {
-    { 0x0C, 0xE0, 0xFF },  // NOP $FFE0
-    { 0xAD, 0xE0, 0xFF },  // LDA $FFE0
-    { 0x0C, 0xE0, 0x1F },  // NOP $1FE0
-    { 0xAD, 0xE0, 0x1F }   // LDA $1FE0
-  };
   for(uInt32 i = 0; i < 4; ++i)
   {
-    if(searchForBytes(image, size, signature[i], 3, 1))
+    if(found[SIG_EF + i])
     {
       isEF = true;
       break;
@@ -841,74 +845,121 @@ bool Cartridge::isProbablyFA2(const uInt8* image, uInt32 size)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyFE(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyFE(const bool* found)
 {
   // FE bankswitching is very weird, but always seems to include a
   // 'JSR $xxxx'
-  // These signatures are attributed to the MESS project
-  uInt8 signature[4][5] = {
-    { 0x20, 0x00, 0xD0, 0xC6, 0xC5 },  // JSR $D000; DEC $C5
-    { 0x20, 0xC3, 0xF8, 0xA5, 0x82 },  // JSR $F8C3; LDA $82
-    { 0xD0, 0xFB, 0x20, 0x73, 0xFE },  // BNE $FB; JSR $FE73
-    { 0x20, 0x00, 0xF0, 0x84, 0xD6 }   // JSR $F000; STY $D6
-  };
   for(uInt32 i = 0; i < 4; ++i)
-    if(searchForBytes(image, size, signature[i], 5, 1))
+    if(found[SIG_FE + i])
       return true;
 
   return false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablySB(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablySB(const bool* found)
 {
   // SB cart bankswitching switches banks by accessing address 0x0800
-  uInt8 signature[2][3] = {
-    { 0xBD, 0x00, 0x08 },  // LDA $0800,x
-    { 0xAD, 0x00, 0x08 }   // LDA $0800
-  };
-  if(searchForBytes(image, size, signature[0], 3, 1))
-    return true;
-  else
-    return searchForBytes(image, size, signature[1], 3, 1);
+  return found[SIG_SB] || found[SIG_SB + 1];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyUA(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyUA(const bool* found)
 {
   // UA cart bankswitching switches to bank 1 by accessing address 0x240
   // using 'STA $240' or 'LDA $240'
-  uInt8 signature[3][3] = {
-    { 0x8D, 0x40, 0x02 },  // STA $240
-    { 0xAD, 0x40, 0x02 },  // LDA $240
-    { 0xBD, 0x1F, 0x02 }   // LDA $21F,X
-  };
   for(uInt32 i = 0; i < 3; ++i)
-    if(searchForBytes(image, size, signature[i], 3, 1))
+    if(found[SIG_UA + i])
       return true;
 
   return false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyX07(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyX07(const bool* found)
 {
   // X07 bankswitching switches to bank 0, 1, 2, etc by accessing address 0x08xd
-  uInt8 signature[6][3] = {
-    { 0xAD, 0x0D, 0x08 },  // LDA $080D
-    { 0xAD, 0x1D, 0x08 },  // LDA $081D
-    { 0xAD, 0x2D, 0x08 },  // LDA $082D
-    { 0x0C, 0x0D, 0x08 },  // NOP $080D
-    { 0x0C, 0x1D, 0x08 },  // NOP $081D
-    { 0x0C, 0x2D, 0x08 }   // NOP $082D
-  };
   for(uInt32 i = 0; i < 6; ++i)
-    if(searchForBytes(image, size, signature[i], 3, 1))
+    if(found[SIG_X07 + i])
       return true;
 
   return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const Cartridge::Signature Cartridge::ourSignatures[SIG_COUNT] = {
+  // F8 (potential)
+  { 3, 2, { 0x8D, 0xF9, 0x1F } },              // STA $1FF9
+
+  // 0840
+  { 3, 2, { 0xAD, 0x00, 0x08 } },              // LDA $0800
+  { 3, 2, { 0xAD, 0x40, 0x08 } },              // LDA $0840
+  { 3, 2, { 0x2C, 0x00, 0x08 } },              // BIT $0800
+  { 4, 2, { 0x0C, 0x00, 0x08, 0x4C } },        // NOP $0800; JMP ...
+  { 4, 2, { 0x0C, 0xFF, 0x0F, 0x4C } },        // NOP $0FFF; JMP ...
+
+  // 3E
+  { 4, 1, { 0x85, 0x3E, 0xA9, 0x00 } },        // STA $3E; LDA #$00
+
+  // 3F
+  { 2, 2, { 0x85, 0x3F } },                    // STA $3F
+
+  // CV; these signatures are attributed to the MESS project
+  { 3, 1, { 0x9D, 0xFF, 0xF3 } },              // STA $F3FF.X
+  { 3, 1, { 0x99, 0x00, 0xF4 } },              // STA $F400.Y
+
+  // DPC+
+  { 4, 2, { 'D', 'P', 'C', '+' } },
+
+  // E0; these signatures are attributed to the MESS project
+  { 3, 1, { 0x8D, 0xE0, 0x1F } },              // STA $1FE0
+  { 3, 1, { 0x8D, 0xE0, 0x5F } },              // STA $5FE0
+  { 3, 1, { 0x8D, 0xE9, 0xFF } },              // STA $FFE9
+  { 3, 1, { 0x0C, 0xE0, 0x1F } },              // NOP $1FE0
+  { 3, 1, { 0xAD, 0xE0, 0x1F } },              // LDA $1FE0
+  { 3, 1, { 0xAD, 0xE9, 0xFF } },              // LDA $FFE9
+  { 3, 1, { 0xAD, 0xED, 0xFF } },              // LDA $FFED
+  { 3, 1, { 0xAD, 0xF3, 0xBF } },              // LDA $BFF3
+
+  // E7; these signatures are attributed to the MESS project
+  { 3, 1, { 0xAD, 0xE2, 0xFF } },              // LDA $FFE2
+  { 3, 1, { 0xAD, 0xE5, 0xFF } },              // LDA $FFE5
+  { 3, 1, { 0xAD, 0xE5, 0x1F } },              // LDA $1FE5
+  { 3, 1, { 0xAD, 0xE7, 0x1F } },              // LDA $1FE7
+  { 3, 1, { 0x0C, 0xE7, 0x1F } },              // NOP $1FE7
+  { 3, 1, { 0x8D, 0xE7, 0xFF } },              // STA $FFE7
+  { 3, 1, { 0x8D, 0xE7, 0x1F } },              // STA $1FE7
+
+  // EF
+  { 3, 1, { 0x0C, 0xE0, 0xFF } },              // NOP $FFE0
+  { 3, 1, { 0xAD, 0xE0, 0xFF } },              // LDA $FFE0
+  { 3, 1, { 0x0C, 0xE0, 0x1F } },              // NOP $1FE0
+  { 3, 1, { 0xAD, 0xE0, 0x1F } },              // LDA $1FE0
+
+  // FE; these signatures are attributed to the MESS project
+  { 5, 1, { 0x20, 0x00, 0xD0, 0xC6, 0xC5 } },  // JSR $D000; DEC $C5
+  { 5, 1, { 0x20, 0xC3, 0xF8, 0xA5, 0x82 } },  // JSR $F8C3; LDA $82
+  { 5, 1, { 0xD0, 0xFB, 0x20, 0x73, 0xFE } },  // BNE $FB; JSR $FE73
+  { 5, 1, { 0x20, 0x00, 0xF0, 0x84, 0xD6 } },  // JSR $F000; STY $D6
+
+  // SB
+  { 3, 1, { 0xBD, 0x00, 0x08 } },              // LDA $0800,x
+  { 3, 1, { 0xAD, 0x00, 0x08 } },              // LDA $0800
+
+  // UA
+  { 3, 1, { 0x8D, 0x40, 0x02 } },              // STA $240
+  { 3, 1, { 0xAD, 0x40, 0x02 } },              // LDA $240
+  { 3, 1, { 0xBD, 0x1F, 0x02 } },              // LDA $21F,X
+
+  // X07
+  { 3, 1, { 0xAD, 0x0D, 0x08 } },              // LDA $080D
+  { 3, 1, { 0xAD, 0x1D, 0x08 } },              // LDA $081D
+  { 3, 1, { 0xAD, 0x2D, 0x08 } },              // LDA $082D
+  { 3, 1, { 0x0C, 0x0D, 0x08 } },              // NOP $080D
+  { 3, 1, { 0x0C, 0x1D, 0x08 } },              // NOP $081D
+  { 3, 1, { 0x0C, 0x2D, 0x08 } }               // NOP $082D
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Cartridge::Cartridge(const Cartridge& cart)
   : mySettings(cart.mySettings)
@@ -227,6 +227,33 @@ class Cartridge : public Device
     void createCodeAccessBase(uInt32 size);
 
   private:
+    // Indices into ourSignatures of the first signature for each test
+    // (and the number of signatures it has)
+    enum {
+      SIG_F8      = 0,               // 1
+      SIG_0840    = SIG_F8 + 1,      // 5
+      SIG_3E      = SIG_0840 + 5,    // 1
+      SIG_3F      = SIG_3E + 1,      // 1
+      SIG_CV      = SIG_3F + 1,      // 2
+      SIG_DPCPLUS = SIG_CV + 2,      // 1
+      SIG_E0      = SIG_DPCPLUS + 1, // 8
+      SIG_E7      = SIG_E0 + 8,      // 7
+      SIG_EF      = SIG_E7 + 7,      // 4
+      SIG_FE      = SIG_EF + 4,      // 4
+      SIG_SB      = SIG_FE + 4,      // 2
+      SIG_UA      = SIG_SB + 2,      // 3
+      SIG_X07     = SIG_UA + 3,      // 6
+      SIG_COUNT   = SIG_X07 + 6
+    };
+
+    // A byte sequence to search for when autodetecting the cart type,
+    // and the minimum number of times it must occur to count as found
+    struct Signature {
+      uInt8 size;
+      uInt8 minhits;
+      uInt8 bytes[5];
+    };
+
     /**
       Get an image pointer and size for a ROM that is part of a larger,
       multi-ROM image.
@@ -266,6 +293,18 @@ class Cartridge : public Device
                                const uInt8* signature, uInt32 sigsize,
                                uInt32 minhits);
 
+    /**
+      Search the image for all the signatures in ourSignatures at once,
+      in a single pass.  For each, this answers what searchForBytes()
+      would for the whole image.
+
+      @param image  A pointer to the ROM image
+      @param size   The size of the ROM image
+      @param found  Set to whether each signature was found at least its
+                    'minhits' times (indexed by SIG_xx)
+    */
+    static void scanForSignatures(const uInt8* image, uInt32 size, bool* found);
+
     /**
       Returns true if the image is probably a SuperChip (256 bytes RAM)
     */
@@ -284,17 +323,17 @@ class Cartridge : public Device
     /**
       Returns true if the image is probably a 0840 bankswitching cartridge
     */
-    static bool isProbably0840(const uInt8* image, uInt32 size);
+    static bool isProbably0840(const bool* found);
 
     /**
       Returns true if the image is probably a 3E bankswitching cartridge
     */
-    static bool isProbably3E(const uInt8* image, uInt32 size);
+    static bool isProbably3E(const bool* found);
 
     /**
       Returns true if the image is probably a 3F bankswitching cartridge
     */
-    static bool isProbably3F(const uInt8* image, uInt32 size);
+    static bool isProbably3F(const bool* found);
 
     /**
       Returns true if the image is probably a 4A50 bankswitching cartridge
@@ -304,32 +343,33 @@ class Cartridge : public Device
     /**
       Returns true if the image is probably a CTY bankswitching cartridge
     */
-    static bool isProbablyCTY(const uInt8* image, uInt32 size);
+    static bool isProbablyCTY(const bool* found);
 
     /**
       Returns true if the image is probably a CV bankswitching cartridge
     */
-    static bool isProbablyCV(const uInt8* image, uInt32 size);
+    static bool isProbablyCV(const bool* found);
 
     /**
       Returns true if the image is probably a DPC+ bankswitching cartridge
     */
-    static bool isProbablyDPCplus(const uInt8* image, uInt32 size);
+    static bool isProbablyDPCplus(const bool* found);
 
     /**
       Returns true if the image is probably a E0 bankswitching cartridge
     */
-    static bool isProbablyE0(const uInt8* image, uInt32 size);
+    static bool isProbablyE0(const bool* found);
 
     /**
       Returns true if the image is probably a E7 bankswitching cartridge
     */
-    static bool isProbablyE7(const uInt8* image, uInt32 size);
+    static bool isProbablyE7(const bool* found);
 
     /**
       Returns true if the image is probably an EF/EFSC bankswitching cartridge
     */
-    static bool isProbablyEF(const uInt8* image, uInt32 size, const char*& type);
+    static bool isProbablyEF(const uInt8* image, uInt32 size,
+                             const bool* found, const char*& type);
 
     /**
       Returns true if the image is probably a BF/BFSC bankswitching cartridge
@@ -353,22 +393,22 @@ class Cartridge : public Device
     /**
       Returns true if the image is probably an FE bankswitching cartridge
     */
-    static bool isProbablyFE(const uInt8* image, uInt32 size);
+    static bool isProbablyFE(const bool* found);
 
     /**
       Returns true if the image is probably a SB bankswitching cartridge
     */
-    static bool isProbablySB(const uInt8* image, uInt32 size);
+    static bool isProbablySB(const bool* found);
 
     /**
       Returns true if the image is probably a UA bankswitching cartridge
     */
-    static bool isProbablyUA(const uInt8* image, uInt32 size);
+    static bool isProbablyUA(const bool* found);
 
     /**
       Returns true if the image is probably an X07 bankswitching cartridge
     */
-    static bool isProbablyX07(const uInt8* image, uInt32 size);
+    static bool isProbablyX07(const bool* found);
 
   protected:
     // Settings class for the application
@@ -395,6 +435,9 @@ class Cartridge : public Device
     // Contains info about this cartridge in string format
     static string myAboutString;
 
+    // Signatures searched for in every image by scanForSignatures()
+    static const Signature ourSignatures[SIG_COUNT];
+
     // Copy constructor isn't supported by cartridges so make it private
     Cartridge(const Cartridge&);
 
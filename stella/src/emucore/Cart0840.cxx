@@ -190,7 +190,7 @@ const uInt8* Cartridge0840::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge0840::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
    out.putShort(myCurrentBank);
 
    return true;
@@ -199,7 +199,7 @@ bool Cartridge0840::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge0840::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    myCurrentBank = in.getShort();
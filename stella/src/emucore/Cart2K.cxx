@@ -132,7 +132,7 @@ const uInt8* Cartridge2K::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge2K::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
 
    return true;
 }
@@ -140,7 +140,7 @@ bool Cartridge2K::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge2K::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    return true;
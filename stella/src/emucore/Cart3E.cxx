@@ -55,7 +55,7 @@ Cartridge3E::~Cartridge3E()
 void Cartridge3E::reset()
 {
   // Initialize RAM
-  if(mySettings.getBool("ramrandom"))
+  if(mySettings.getBool(Settings::RAMRandom))
     for(uInt32 i = 0; i < 32768; ++i)
       myRAM[i] = mySystem->randGenerator().next();
   else
@@ -266,7 +266,7 @@ const uInt8* Cartridge3E::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge3E::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
    out.putShort(myCurrentBank);
    out.putByteArray(myRAM, 32768);
 
@@ -276,7 +276,7 @@ bool Cartridge3E::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge3E::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    myCurrentBank = in.getShort();
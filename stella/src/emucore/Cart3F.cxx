@@ -184,7 +184,7 @@ const uInt8* Cartridge3F::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge3F::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
    out.putShort(myCurrentBank);
 
    return true;
@@ -193,7 +193,7 @@ bool Cartridge3F::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge3F::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    myCurrentBank = in.getShort();
@@ -55,7 +55,7 @@ Cartridge4A50::~Cartridge4A50()
 void Cartridge4A50::reset()
 {
   // Initialize RAM
-  if(mySettings.getBool("ramrandom"))
+  if(mySettings.getBool(Settings::RAMRandom))
     for(uInt32 i = 0; i < 32768; ++i)
       myRAM[i] = mySystem->randGenerator().next();
   else
@@ -330,7 +330,7 @@ const uInt8* Cartridge4A50::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge4A50::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
 
    // The 32K bytes of RAM
    out.putByteArray(myRAM, 32768);
@@ -355,7 +355,7 @@ bool Cartridge4A50::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge4A50::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    in.getByteArray(myRAM, 32768);
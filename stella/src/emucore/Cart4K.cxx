@@ -109,7 +109,7 @@ const uInt8* Cartridge4K::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge4K::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
 
    return true;
 }
@@ -117,7 +117,7 @@ bool Cartridge4K::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge4K::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    return true;
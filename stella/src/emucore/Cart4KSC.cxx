@@ -43,7 +43,7 @@ Cartridge4KSC::~Cartridge4KSC()
 void Cartridge4KSC::reset()
 {
   // Initialize RAM
-  if(mySettings.getBool("ramrandom"))
+  if(mySettings.getBool(Settings::RAMRandom))
     for(uInt32 i = 0; i < 128; ++i)
       myRAM[i] = mySystem->randGenerator().next();
   else
@@ -166,7 +166,7 @@ const uInt8* Cartridge4KSC::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge4KSC::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
    out.putShort(myCurrentBank);
    out.putByteArray(myRAM, 128);
 
@@ -176,7 +176,7 @@ bool Cartridge4KSC::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge4KSC::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    myCurrentBank = in.getShort();
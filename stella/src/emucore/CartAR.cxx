@@ -57,7 +57,7 @@ void CartridgeAR::reset()
 {
   // Initialize RAM
 #if 0  // TODO - figure out actual behaviour of the real cart
-  if(mySettings.getBool("ramrandom"))
+  if(mySettings.getBool(Settings::RAMRandom))
     for(uInt32 i = 0; i < 6 * 1024; ++i)
       myImage[i] = mySystem->randGenerator().next();
   else
@@ -97,6 +97,10 @@ void CartridgeAR::install(System& system)
 
   my6502       = &(mySystem->m6502());
 
+  // The Supercharger relies on the number of distinct accesses made
+  // by the CPU, which is otherwise not tracked
+  my6502->countDistinctAccesses(true);
+
   // Map all of the accesses to call peek and poke (we don't yet indicate RAM areas)
   System::PageAccess access(0, 0, 0, this, System::PA_READ);
 
@@ -320,7 +324,7 @@ void CartridgeAR::initializeROM()
   // The scrom.asm code checks a value at offset 109 as follows:
   //   0xFF -> do a complete jump over the SC BIOS progress bars code
   //   0x00 -> show SC BIOS progress bars as normal
-  ourDummyROMCode[109] = mySettings.getBool("fastscbios") ? 0xFF : 0x00;
+  ourDummyROMCode[109] = mySettings.getBool(Settings::FastSCBios) ? 0xFF : 0x00;
 
   // The accumulator should contain a random value after exiting the
   // SC BIOS code - a value placed in offset 281 will be stored in A
@@ -432,7 +436,7 @@ const uInt8* CartridgeAR::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeAR::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
 
    // Indicates the offest within the image for the corresponding bank
    out.putIntArray(myImageOffset, 2);
@@ -474,7 +478,7 @@ bool CartridgeAR::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeAR::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    // Indicates the offest within the image for the corresponding bank
@@ -139,7 +139,7 @@ const uInt8* CartridgeBF::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeBF::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
    out.putShort(myCurrentBank);
 
    return true;
@@ -148,7 +148,7 @@ bool CartridgeBF::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeBF::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    myCurrentBank = in.getShort();
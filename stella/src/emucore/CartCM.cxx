@@ -50,7 +50,7 @@ CartridgeCM::~CartridgeCM()
 void CartridgeCM::reset()
 {
   // Initialize RAM
-  if(mySettings.getBool("ramrandom"))
+  if(mySettings.getBool(Settings::RAMRandom))
     for(uInt32 i = 0; i < 2048; ++i)
       myRAM[i] = mySystem->randGenerator().next();
   else
@@ -194,7 +194,7 @@ const uInt8* CartridgeCM::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeCM::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
    out.putShort(myCurrentBank);
    out.putByte(mySWCHA);
    out.putByte(myColumn);
@@ -206,7 +206,7 @@ bool CartridgeCM::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeCM::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    myCurrentBank = in.getShort();
@@ -60,7 +60,7 @@ CartridgeCTY::~CartridgeCTY()
 void CartridgeCTY::reset()
 {
   // Initialize RAM
-  if(mySettings.getBool("ramrandom"))
+  if(mySettings.getBool(Settings::RAMRandom))
     for(uInt32 i = 0; i < 64; ++i)
       myRAM[i] = mySystem->randGenerator().next();
   else
@@ -301,7 +301,7 @@ const uInt8* CartridgeCTY::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeCTY::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
    out.putShort(bank());
    out.putByteArray(myRAM, 64);
 
@@ -318,7 +318,7 @@ bool CartridgeCTY::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeCTY::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    // Remember what bank we were in
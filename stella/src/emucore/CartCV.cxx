@@ -69,7 +69,7 @@ void CartridgeCV::reset()
   else
   {
     // Initialize RAM
-    if(mySettings.getBool("ramrandom"))
+    if(mySettings.getBool(Settings::RAMRandom))
       for(uInt32 i = 0; i < 1024; ++i)
         myRAM[i] = mySystem->randGenerator().next();
     else
@@ -196,7 +196,7 @@ const uInt8* CartridgeCV::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeCV::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
    out.putByteArray(myRAM, 1024);
 
    return true;
@@ -205,7 +205,7 @@ bool CartridgeCV::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeCV::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    in.getByteArray(myRAM, 1024);
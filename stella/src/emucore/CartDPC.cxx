@@ -28,7 +28,7 @@ CartridgeDPC::CartridgeDPC(const uInt8* image, uInt32 size,
   : Cartridge(settings),
     mySize(size),
     mySystemCycles(0),
-    myFractionalClocks(0.0)
+    myFractionalClocks(0)
 {
   // Make a copy of the entire image
   memcpy(myImage, image, MIN(size, 8192u + 2048u + 256u));
@@ -64,7 +64,7 @@ void CartridgeDPC::reset()
 {
   // Update cycles to the current system cycles
   mySystemCycles = mySystem->cycles();
-  myFractionalClocks = 0.0;
+  myFractionalClocks = 0;
 
   // Upon reset we switch to the startup bank
   bank(myStartBank);
@@ -121,15 +121,17 @@ inline void CartridgeDPC::updateMusicModeDataFetchers()
   Int32 cycles = mySystem->cycles() - mySystemCycles;
   mySystemCycles = mySystem->cycles();
 
-  // Calculate the number of DPC OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  Int32 wholeClocks = (Int32)clocks;
-  myFractionalClocks = clocks - (double)wholeClocks;
+  if(cycles <= 0)
+    return;
 
-  if(wholeClocks <= 0)
-  {
+  // Calculate the number of DPC OSC clocks since the last update, keeping
+  // the remainder exactly so that no time is lost between updates
+  uInt64 clocks = (uInt64)cycles * kClockMultiplier + myFractionalClocks;
+  Int32 wholeClocks = (Int32)(clocks / kClockDivisor);
+  myFractionalClocks = (uInt32)(clocks % kClockDivisor);
+
+  if(wholeClocks == 0)
     return;
-  }
 
   // Let's update counters and flags of the music mode data fetchers
   for(int x = 5; x <= 7; ++x)
@@ -142,7 +144,8 @@ inline void CartridgeDPC::updateMusicModeDataFetchers()
 
       if(myTops[x] != 0)
       {
-        newLow -= (wholeClocks % top);
+        // Usually only a clock or two has passed, so avoid the division
+        newLow -= (wholeClocks < top) ? wholeClocks : (wholeClocks % top);
         if(newLow < 0)
         {
           newLow += top;
@@ -470,7 +473,7 @@ const uInt8* CartridgeDPC::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeDPC::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
 
    // Indicates which bank is currently active
    out.putShort(myCurrentBank);
@@ -495,7 +498,7 @@ bool CartridgeDPC::save(Serializer& out) const
    out.putByte(myRandomNumber);
 
    out.putInt(mySystemCycles);
-   out.putInt((uInt32)(myFractionalClocks * 100000000.0));
+   out.putInt(myFractionalClocks);
 
    return true;
 }
@@ -503,7 +506,7 @@ bool CartridgeDPC::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeDPC::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    // Indicates which bank is currently active
@@ -529,8 +532,14 @@ bool CartridgeDPC::load(Serializer& in)
    myRandomNumber = in.getByte();
 
    // Get system cycles and fractional clocks
+   // States in the original format hold the fraction scaled by 1e8
    mySystemCycles = (Int32)in.getInt();
-   myFractionalClocks = (double)in.getInt() / 100000000.0;
+   uInt32 fractionalClocks = in.getInt();
+   if(in.isCompact())
+     myFractionalClocks = fractionalClocks % kClockDivisor;
+   else
+     myFractionalClocks =
+       (uInt32)((uInt64)fractionalClocks * kClockDivisor / 100000000);
 
    // Now, go to the current bank
    bank(myCurrentBank);
@@ -200,8 +200,16 @@ class CartridgeDPC : public Cartridge
     // System cycle count when the last update to music data fetchers occurred
     Int32 mySystemCycles;
 
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    // Fraction of a DPC music OSC clock unused during the last update,
+    // in units of 1 / kClockDivisor
+    uInt32 myFractionalClocks;
+
+    // The music OSC runs at 20 kHz and the CPU at 3579575 / 3 Hz, so each
+    // CPU cycle is exactly kClockMultiplier / kClockDivisor OSC clocks
+    enum {
+      kClockMultiplier = 20000 * 3,
+      kClockDivisor    = 3579575
+    };
 };
 
 #endif
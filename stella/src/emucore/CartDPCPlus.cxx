@@ -31,7 +31,7 @@ CartridgeDPCPlus::CartridgeDPCPlus(const uInt8* image, uInt32 size,
     myLDAimmediate(false),
     myParameterPointer(0),
     mySystemCycles(0),
-    myFractionalClocks(0.0)
+    myFractionalClocks(0)
 {
   // Store image, making sure it's at least 29KB
   uInt32 minsize = 4096 * 6 + 4096 + 1024 + 255;
@@ -58,7 +58,7 @@ CartridgeDPCPlus::CartridgeDPCPlus(const uInt8* image, uInt32 size,
   // Create Thumbulator ARM emulator
   myThumbEmulator = new Thumbulator((uInt16*)(myProgramImage-0xC00),
                                     (uInt16*)myDPCRAM,
-                                     settings.getBool("thumb.trapfatal"));
+                                     settings.getBool(Settings::ThumbTrapFatal));
 #endif
   setInitialState();
 
@@ -81,7 +81,7 @@ void CartridgeDPCPlus::reset()
 {
   // Update cycles to the current system cycles
   mySystemCycles = mySystem->cycles();
-  myFractionalClocks = 0.0;
+  myFractionalClocks = 0;
 
   setInitialState();
 
@@ -160,20 +160,23 @@ inline void CartridgeDPCPlus::updateMusicModeDataFetchers()
   Int32 cycles = mySystem->cycles() - mySystemCycles;
   mySystemCycles = mySystem->cycles();
 
-  // Calculate the number of DPC OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  Int32 wholeClocks = (Int32)clocks;
-  myFractionalClocks = clocks - (double)wholeClocks;
+  if(cycles <= 0)
+    return;
 
-  if(wholeClocks <= 0)
-  {
+  // Calculate the number of DPC OSC clocks since the last update, keeping
+  // the remainder exactly so that no time is lost between updates
+  uInt64 clocks = (uInt64)cycles * kClockMultiplier + myFractionalClocks;
+  Int32 wholeClocks = (Int32)(clocks / kClockDivisor);
+  myFractionalClocks = (uInt32)(clocks % kClockDivisor);
+
+  if(wholeClocks == 0)
     return;
-  }
 
-  // Let's update counters and flags of the music mode data fetchers
+  // Each OSC clock adds the frequency to the counter, so all the clocks
+  // since the last update can be applied at once
   for(int x = 0; x <= 2; ++x)
   {
-    myMusicCounters[x] += myMusicFrequencies[x];
+    myMusicCounters[x] += myMusicFrequencies[x] * (uInt32)wholeClocks;
   }
 }
 
@@ -622,6 +625,10 @@ bool CartridgeDPCPlus::patch(uInt16 address, uInt8 value)
   if(address >= 0x0080)
   {
     myProgramImage[(myCurrentBank << 12) + (address & 0x0FFF)] = value;
+#ifdef THUMB_SUPPORT
+    // The ARM code may have been patched
+    myThumbEmulator->romChanged();
+#endif
     return myBankChanged = true;
   }
   else
@@ -638,7 +645,7 @@ const uInt8* CartridgeDPCPlus::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeDPCPlus::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
 
    // Indicates which bank is currently active
    out.putShort(myCurrentBank);
@@ -681,7 +688,7 @@ bool CartridgeDPCPlus::save(Serializer& out) const
    out.putInt(myRandomNumber);
 
    out.putInt(mySystemCycles);
-   out.putInt((uInt32)(myFractionalClocks * 100000000.0));
+   out.putInt(myFractionalClocks);
 
    return true;
 }
@@ -689,7 +696,7 @@ bool CartridgeDPCPlus::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeDPCPlus::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    // Indicates which bank is currently active
@@ -733,8 +740,14 @@ bool CartridgeDPCPlus::load(Serializer& in)
    myRandomNumber = in.getInt();
 
    // Get system cycles and fractional clocks
+   // States in the original format hold the fraction scaled by 1e8
    mySystemCycles = (Int32)in.getInt();
-   myFractionalClocks = (double)in.getInt() / 100000000.0;
+   uInt32 fractionalClocks = in.getInt();
+   if(in.isCompact())
+     myFractionalClocks = fractionalClocks % kClockDivisor;
+   else
+     myFractionalClocks =
+       (uInt32)((uInt64)fractionalClocks * kClockDivisor / 100000000);
 
    // Now, go to the current bank
    bank(myCurrentBank);
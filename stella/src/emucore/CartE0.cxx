@@ -227,7 +227,7 @@ const uInt8* CartridgeE0::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeE0::save(Serializer& out) const
 {
-  out.putString(name());
+  out.putTag(name());
   out.putShortArray(myCurrentSlice, 4);
   return true;
 }
@@ -235,7 +235,7 @@ bool CartridgeE0::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeE0::load(Serializer& in)
 {
-  if(in.getString() != name())
+  if(!in.getTag(name()))
     return false;
 
   in.getShortArray(myCurrentSlice, 4);
@@ -50,7 +50,7 @@ CartridgeE7::~CartridgeE7()
 void CartridgeE7::reset()
 {
   // Initialize RAM
-  if(mySettings.getBool("ramrandom"))
+  if(mySettings.getBool(Settings::RAMRandom))
     for(uInt32 i = 0; i < 2048; ++i)
       myRAM[i] = mySystem->randGenerator().next();
   else
@@ -293,7 +293,7 @@ const uInt8* CartridgeE7::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeE7::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
    out.putShortArray(myCurrentSlice, 2);
    out.putShort(myCurrentRAM);
    out.putByteArray(myRAM, 2048);
@@ -304,7 +304,7 @@ bool CartridgeE7::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeE7::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    in.getShortArray(myCurrentSlice, 2);
@@ -139,7 +139,7 @@ const uInt8* CartridgeEF::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeEF::save(Serializer& out) const
 {
-  out.putString(name());
+  out.putTag(name());
   out.putShort(myCurrentBank);
   return true;
 }
@@ -147,7 +147,7 @@ bool CartridgeEF::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeEF::load(Serializer& in)
 {
-  if(in.getString() != name())
+  if(!in.getTag(name()))
     return false;
 
   myCurrentBank = in.getShort();
@@ -46,7 +46,7 @@ CartridgeEFSC::~CartridgeEFSC()
 void CartridgeEFSC::reset()
 {
   // Initialize RAM
-  if(mySettings.getBool("ramrandom"))
+  if(mySettings.getBool(Settings::RAMRandom))
     for(uInt32 i = 0; i < 128; ++i)
       myRAM[i] = mySystem->randGenerator().next();
   else
@@ -200,7 +200,7 @@ const uInt8* CartridgeEFSC::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeEFSC::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
    out.putShort(myCurrentBank);
    out.putByteArray(myRAM, 128);
 
@@ -210,7 +210,7 @@ bool CartridgeEFSC::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeEFSC::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    myCurrentBank = in.getShort();
@@ -62,7 +62,7 @@ CartridgeFA2::~CartridgeFA2()
 void CartridgeFA2::reset()
 {
   // Initialize RAM
-  if(mySettings.getBool("ramrandom"))
+  if(mySettings.getBool(Settings::RAMRandom))
     for(uInt32 i = 0; i < 256; ++i)
       myRAM[i] = mySystem->randGenerator().next();
   else
@@ -306,7 +306,7 @@ const uInt8* CartridgeFA2::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeFA2::save(Serializer& out) const
 {
-  out.putString(name());
+  out.putTag(name());
   out.putShort(myCurrentBank);
   out.putByteArray(myRAM, 256);
 
@@ -316,7 +316,7 @@ bool CartridgeFA2::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeFA2::load(Serializer& in)
 {
-  if(in.getString() != name())
+  if(!in.getTag(name()))
     return false;
 
   myCurrentBank = in.getShort();
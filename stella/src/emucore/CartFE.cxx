@@ -137,7 +137,7 @@ const uInt8* CartridgeFE::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeFE::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
    out.putShort(myLastAddress1);
    out.putShort(myLastAddress2);
 
@@ -147,7 +147,7 @@ bool CartridgeFE::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeFE::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    myLastAddress1 = in.getShort();
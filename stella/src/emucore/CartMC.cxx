@@ -51,7 +51,7 @@ CartridgeMC::~CartridgeMC()
 void CartridgeMC::reset()
 {
   // Initialize RAM
-  if(mySettings.getBool("ramrandom"))
+  if(mySettings.getBool(Settings::RAMRandom))
     for(uInt32 i = 0; i < 32768; ++i)
       myRAM[i] = mySystem->randGenerator().next();
   else
@@ -238,7 +238,7 @@ const uInt8* CartridgeMC::getImage(int& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeMC::save(Serializer& out) const
 {
-  out.putString(name());
+  out.putTag(name());
 
   // The currentBlock array
   out.putByteArray(myCurrentBlock, 4);
@@ -252,7 +252,7 @@ bool CartridgeMC::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeMC::load(Serializer& in)
 {
-  if(in.getString() != name())
+  if(!in.getTag(name()))
     return false;
 
   // The currentBlock array
@@ -110,17 +110,26 @@ Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
   // Auto-detect NTSC/PAL mode if it's requested
   string autodetected = "";
   myDisplayFormat = myProperties.get(Display_Format);
-  if(myDisplayFormat == "AUTO" || myOSystem->settings().getBool("rominfo"))
+  if(myDisplayFormat == "AUTO" || myOSystem->settings().getBool(Settings::RomInfo))
   {
     // Run the TIA, looking for PAL scanline patterns
     // We turn off the SuperCharger progress bars, otherwise the SC BIOS
     // will take over 250 frames!
     // The 'fastscbios' option must be changed before the system is reset
-    bool fastscbios = myOSystem->settings().getBool("fastscbios");
-    myOSystem->settings().setValue("fastscbios", true);
+    bool fastscbios = myOSystem->settings().getBool(Settings::FastSCBios);
+    myOSystem->settings().setValue(Settings::FastSCBios, true);
     mySystem->reset(true);  // autodetect in reset enabled
-    for(int i = 0; i < 60; ++i)
+
+    // These frames are never shown, so no pixels are drawn, and we stop as
+    // soon as the remaining frames can't change the outcome any more
+    myTIA->enableRendering(false);
+    for(int i = 1; i <= 60; ++i)
+    {
       myTIA->update();
+      if(myTIA->isPALSettled(60 - i))
+        break;
+    }
+    myTIA->enableRendering(true);
     myDisplayFormat = myTIA->isPAL() ? "PAL" : "NTSC";
     if(myProperties.get(Display_Format) == "AUTO")
     {
@@ -129,7 +138,7 @@ Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
     }
 
     // Don't forget to reset the SC progress bars again
-    myOSystem->settings().setValue("fastscbios", fastscbios);
+    myOSystem->settings().setValue(Settings::FastSCBios, fastscbios);
   }
   myConsoleInfo.DisplayFormat = myDisplayFormat + autodetected;
 
@@ -155,7 +164,7 @@ Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
   // Other ROMs can use it if the setting is enabled
   bool joyallow4 = md5 == "aa1c41f86ec44c0a44eb64c332ce08af" ||
                    md5 == "1bf503c724001b09be79c515ecfcbd03" ||
-                   myOSystem->settings().getBool("joyallow4");
+                   myOSystem->settings().getBool(Settings::JoyAllow4);
   myOSystem->eventHandler().allowAllDirections(joyallow4);
 
   // Reset the system to its power-on state
@@ -211,6 +220,29 @@ bool Console::load(Serializer& in)
   return true;  // success
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Console::saveSnapshot(uInt8* buffer, uInt32 size) const
+{
+  // Device name tags are left out, as in the compact state format
+  Serializer out(buffer, size);
+  out.setCompact(true);
+  out.putInt(kSnapshotMagic);
+
+  if(!save(out) || !out.isValid())
+    return 0;
+
+  return out.size();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Console::loadSnapshot(const uInt8* buffer, uInt32 size)
+{
+  Serializer in((uInt8*)buffer, size, true);
+  in.setCompact(true);
+
+  return in.getInt() == kSnapshotMagic && load(in) && in.isValid();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::toggleFormat(int direction)
 {
@@ -249,7 +281,7 @@ void Console::toggleFormat(int direction)
   }
   myProperties.set(Display_Format, saveformat);
 
-  setPalette(myOSystem->settings().getString("palette"));
+  setPalette(myOSystem->settings().getString(Settings::Palette));
   setTIAProperties();
   myTIA->frameReset();
   initializeVideo();  // takes care of refreshing the screen
@@ -258,8 +290,8 @@ void Console::toggleFormat(int direction)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::toggleColorLoss()
 {
-  bool colorloss = !myOSystem->settings().getBool("colorloss");
-  myOSystem->settings().setValue("colorloss", colorloss);
+  bool colorloss = !myOSystem->settings().getBool(Settings::ColorLoss);
+  myOSystem->settings().setValue(Settings::ColorLoss, colorloss);
   myTIA->enableColorLoss(colorloss);
 }
 
@@ -273,7 +305,7 @@ void Console::toggleColorLoss(bool state)
 void Console::togglePalette()
 {
   string palette;
-  palette = myOSystem->settings().getString("palette");
+  palette = myOSystem->settings().getString(Settings::Palette);
  
   if(palette == "standard")       // switch to z26
   {
@@ -293,7 +325,7 @@ void Console::togglePalette()
   else  // switch to standard mode if we get this far
     palette = "standard";
 
-  myOSystem->settings().setValue("palette", palette);
+  myOSystem->settings().setValue(Settings::Palette, palette);
 
   setPalette(palette);
 }
@@ -348,7 +380,7 @@ void Console::setProperties(const Properties& props)
 void Console::initializeVideo()
 {
   setColorLossPalette();
-  setPalette(myOSystem->settings().getString("palette"));
+  setPalette(myOSystem->settings().getString(Settings::Palette));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -623,7 +655,7 @@ void Console::setControllers(const string& rommd5)
     const string& nvramfile = myOSystem->nvramDir() + "atarivox_eeprom.dat";
     myControllers[rightPort] = new AtariVox(Controller::Right, myEvent,
                    *mySystem, myOSystem->serialPort(),
-                   myOSystem->settings().getString("avoxport"), nvramfile);
+                   myOSystem->settings().getString(Settings::AVoxPort), nvramfile);
   }
   else if(right == "SAVEKEY")
   {
@@ -158,6 +158,28 @@ class Console : public Serializable
     */
     bool load(Serializer& in);
 
+    /**
+      Saves a snapshot of the current state of this console class to the
+      given block of memory.  A snapshot is only meant to be loaded back
+      into the same console (as when running ahead), so unlike a state
+      saved by the StateManager it isn't identified by cart type or
+      protected by a checksum.
+
+      @param buffer The memory block to save to.
+      @param size   The size of the memory block, in bytes.
+      @return The size of the snapshot, or 0 on failure.
+    */
+    uInt32 saveSnapshot(uInt8* buffer, uInt32 size) const;
+
+    /**
+      Loads a snapshot saved by saveSnapshot() from the given block of memory.
+
+      @param buffer The memory block to load from.
+      @param size   The size of the memory block, in bytes.
+      @return The result of the load.  True on success, false on failure.
+    */
+    bool loadSnapshot(const uInt8* buffer, uInt32 size);
+
     /**
       Get a descriptor for this console class (used in error checking).
 
@@ -323,6 +345,10 @@ class Console : public Serializable
     void toggleTIACollision(TIABit bit, const string& bitname, bool show = true) const;
 
   private:
+    enum {
+      kSnapshotMagic = 0x1a733253  // "S2s\x1a"
+    };
+
     // Pointer to the osystem object
     OSystem* myOSystem;
 
@@ -17,8 +17,9 @@
 // $Id: M6502.cxx 2838 2014-01-17 23:34:03Z stephena $
 //============================================================================
 
-  // Flags for disassembly types
-  #define DISASM_CODE  0
+  // Flags for disassembly types; code is told apart from the rest
+  // since it's read with fetch() instead of peek()
+  #define DISASM_CODE  1
   #define DISASM_GFX   0
   #define DISASM_PGFX  0
   #define DISASM_DATA  0
@@ -28,6 +29,14 @@
 
 #include "M6502.hxx"
 
+// Use threaded dispatch (computed goto) in execute() where the compiler
+// supports it.  WebAssembly has no indirect branches, so emscripten would
+// lower it back into a switch; define M6502_SWITCH_DISPATCH to force the
+// portable switch-based version.
+#if defined(__GNUC__) && !defined(__EMSCRIPTEN__) && !defined(M6502_SWITCH_DISPATCH)
+  #define M6502_THREADED_DISPATCH
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6502::M6502(uInt32 systemCyclesPerProcessorCycle, const Settings& settings)
   : myExecutionStatus(0),
@@ -38,6 +47,7 @@ M6502::M6502(uInt32 systemCyclesPerProcessorCycle, const Settings& settings)
     myTotalInstructionCount(0),
     myNumberOfDistinctAccesses(0),
     myLastAddress(0),
+    myCountDistinctAccesses(false),
     myLastPeekAddress(0),
     myLastPokeAddress(0),
     myLastSrcAddressS(-1),
@@ -75,7 +85,7 @@ void M6502::reset()
 
   // Set registers to default values
   SP = 0xff;
-  if(mySettings.getBool("cpurandom"))
+  if(mySettings.getBool(Settings::CPURandom))
   {
     A = mySystem->randGenerator().next();
     X = mySystem->randGenerator().next();
@@ -103,16 +113,15 @@ void M6502::reset()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool countAccesses>
 inline uInt8 M6502::peek(uInt16 address, uInt8 flags)
 {
-  ////////////////////////////////////////////////
-  // TODO - move this logic directly into CartAR
-  if(address != myLastAddress)
+  // Only needed by CartAR; see countDistinctAccesses()
+  if(countAccesses && address != myLastAddress)
   {
     myNumberOfDistinctAccesses++;
     myLastAddress = address;
   }
-  ////////////////////////////////////////////////
   mySystem->incrementCycles(mySystemCyclesPerProcessorCycle);
 
   uInt8 result = mySystem->peek(address, flags);
@@ -122,16 +131,33 @@ inline uInt8 M6502::peek(uInt16 address, uInt8 flags)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool countAccesses>
+inline uInt8 M6502::fetch(uInt16 address)
+{
+  // Only needed by CartAR; see countDistinctAccesses()
+  if(countAccesses && address != myLastAddress)
+  {
+    myNumberOfDistinctAccesses++;
+    myLastAddress = address;
+  }
+  mySystem->incrementCycles(mySystemCyclesPerProcessorCycle);
+
+  uInt8 result = mySystem->fetch(address);
+  myLastAccessWasRead = true;
+  myLastPeekAddress = address;
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool countAccesses>
 inline void M6502::poke(uInt16 address, uInt8 value)
 {
-  ////////////////////////////////////////////////
-  // TODO - move this logic directly into CartAR
-  if(address != myLastAddress)
+  // Only needed by CartAR; see countDistinctAccesses()
+  if(countAccesses && address != myLastAddress)
   {
     myNumberOfDistinctAccesses++;
     myLastAddress = address;
   }
-  ////////////////////////////////////////////////
   mySystem->incrementCycles(mySystemCyclesPerProcessorCycle);
 
   mySystem->poke(address, value);
@@ -142,12 +168,110 @@ inline void M6502::poke(uInt16 address, uInt8 value)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6502::execute(uInt32 number)
 {
+  return myCountDistinctAccesses ? executeInstructions<true>(number) :
+                                   executeInstructions<false>(number);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool countAccesses>
+bool M6502::executeInstructions(uInt32 number)
+{
+#ifdef M6502_THREADED_DISPATCH
+  // Handler address for each opcode; undefined opcodes are fatal
+  static const void* const ourOpcodeHandler[256] = {
+    &&op_0x00, &&op_0x01, &&op_illegal, &&op_0x03, &&op_0x04, &&op_0x05, &&op_0x06, &&op_0x07,
+    &&op_0x08, &&op_0x09, &&op_0x0a, &&op_0x0b, &&op_0x0c, &&op_0x0d, &&op_0x0e, &&op_0x0f,
+    &&op_0x10, &&op_0x11, &&op_illegal, &&op_0x13, &&op_0x14, &&op_0x15, &&op_0x16, &&op_0x17,
+    &&op_0x18, &&op_0x19, &&op_0x1a, &&op_0x1b, &&op_0x1c, &&op_0x1d, &&op_0x1e, &&op_0x1f,
+    &&op_0x20, &&op_0x21, &&op_illegal, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_0x27,
+    &&op_0x28, &&op_0x29, &&op_0x2a, &&op_0x2b, &&op_0x2C, &&op_0x2d, &&op_0x2e, &&op_0x2f,
+    &&op_0x30, &&op_0x31, &&op_illegal, &&op_0x33, &&op_0x34, &&op_0x35, &&op_0x36, &&op_0x37,
+    &&op_0x38, &&op_0x39, &&op_0x3a, &&op_0x3b, &&op_0x3c, &&op_0x3d, &&op_0x3e, &&op_0x3f,
+    &&op_0x40, &&op_0x41, &&op_illegal, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+    &&op_0x48, &&op_0x49, &&op_0x4a, &&op_0x4b, &&op_0x4c, &&op_0x4d, &&op_0x4e, &&op_0x4f,
+    &&op_0x50, &&op_0x51, &&op_illegal, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57,
+    &&op_0x58, &&op_0x59, &&op_0x5a, &&op_0x5b, &&op_0x5c, &&op_0x5d, &&op_0x5e, &&op_0x5f,
+    &&op_0x60, &&op_0x61, &&op_illegal, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67,
+    &&op_0x68, &&op_0x69, &&op_0x6a, &&op_0x6b, &&op_0x6c, &&op_0x6d, &&op_0x6e, &&op_0x6f,
+    &&op_0x70, &&op_0x71, &&op_illegal, &&op_0x73, &&op_0x74, &&op_0x75, &&op_0x76, &&op_0x77,
+    &&op_0x78, &&op_0x79, &&op_0x7a, &&op_0x7b, &&op_0x7c, &&op_0x7d, &&op_0x7e, &&op_0x7f,
+    &&op_0x80, &&op_0x81, &&op_0x82, &&op_0x83, &&op_0x84, &&op_0x85, &&op_0x86, &&op_0x87,
+    &&op_0x88, &&op_0x89, &&op_0x8a, &&op_0x8b, &&op_0x8c, &&op_0x8d, &&op_0x8e, &&op_0x8f,
+    &&op_0x90, &&op_0x91, &&op_illegal, &&op_0x93, &&op_0x94, &&op_0x95, &&op_0x96, &&op_0x97,
+    &&op_0x98, &&op_0x99, &&op_0x9a, &&op_0x9b, &&op_0x9c, &&op_0x9d, &&op_0x9e, &&op_0x9f,
+    &&op_0xa0, &&op_0xa1, &&op_0xa2, &&op_0xa3, &&op_0xa4, &&op_0xa5, &&op_0xa6, &&op_0xa7,
+    &&op_0xa8, &&op_0xa9, &&op_0xaa, &&op_0xab, &&op_0xac, &&op_0xad, &&op_0xae, &&op_0xaf,
+    &&op_0xb0, &&op_0xb1, &&op_illegal, &&op_0xb3, &&op_0xb4, &&op_0xb5, &&op_0xb6, &&op_0xb7,
+    &&op_0xb8, &&op_0xb9, &&op_0xba, &&op_0xbb, &&op_0xbc, &&op_0xbd, &&op_0xbe, &&op_0xbf,
+    &&op_0xc0, &&op_0xc1, &&op_0xc2, &&op_0xc3, &&op_0xc4, &&op_0xc5, &&op_0xc6, &&op_0xc7,
+    &&op_0xc8, &&op_0xc9, &&op_0xca, &&op_0xcb, &&op_0xcc, &&op_0xcd, &&op_0xce, &&op_0xcf,
+    &&op_0xD0, &&op_0xd1, &&op_illegal, &&op_0xd3, &&op_0xd4, &&op_0xd5, &&op_0xd6, &&op_0xd7,
+    &&op_0xd8, &&op_0xd9, &&op_0xda, &&op_0xdb, &&op_0xdc, &&op_0xdd, &&op_0xde, &&op_0xdf,
+    &&op_0xe0, &&op_0xe1, &&op_0xe2, &&op_0xe3, &&op_0xe4, &&op_0xe5, &&op_0xe6, &&op_0xe7,
+    &&op_0xe8, &&op_0xe9, &&op_0xea, &&op_0xeb, &&op_0xec, &&op_0xed, &&op_0xee, &&op_0xef,
+    &&op_0xf0, &&op_0xf1, &&op_illegal, &&op_0xf3, &&op_0xf4, &&op_0xf5, &&op_0xf6, &&op_0xf7,
+    &&op_0xf8, &&op_0xf9, &&op_0xfa, &&op_0xfb, &&op_0xfc, &&op_0xfd, &&op_0xfe, &&op_0xff
+  };
+#endif
+
   // Clear all of the execution status bits except for the fatal error bit
   myExecutionStatus &= FatalErrorBit;
 
   // Loop until execution is stopped or a fatal error occurs
   for(;;)
   {
+    // The instruction code accesses memory through these, which use the
+    // variants matching this instantiation (and fetch() for code, which
+    // is always read with a constant DISASM_CODE)
+    #define M6502_PEEK(_address, _flags) ((_flags) == DISASM_CODE ? \
+      fetch<countAccesses>(_address) : peek<countAccesses>(_address, _flags))
+    #define M6502_POKE(_address, _value) poke<countAccesses>(_address, _value)
+
+#ifdef M6502_THREADED_DISPATCH
+    if(!myExecutionStatus && (number != 0))
+    {
+      uInt16 operandAddress, intermediateAddress;
+      uInt8 operand;
+
+      // Each instruction ends by fetching and jumping directly to the
+      // next one, instead of returning to a single shared dispatch point.
+      // This is otherwise identical to the switch-based loop below.
+      #define M6502_FETCH_AND_DISPATCH                                   \
+        operandAddress = intermediateAddress = 0;                        \
+        operand = 0;                                                     \
+        myLastPeekAddress = myLastPokeAddress = myDataAddressForPoke = 0; \
+        IR = fetch<countAccesses>(PC++);                                 \
+        goto *ourOpcodeHandler[IR];
+
+      #define M6502_CASE(_opcode) op_##_opcode:
+      #define M6502_END_CASE                                             \
+        myTotalInstructionCount++;                                       \
+        --number;                                                        \
+        if(!myExecutionStatus && (number != 0))                          \
+        {                                                                \
+          M6502_FETCH_AND_DISPATCH                                       \
+        }                                                                \
+        goto done;
+
+      M6502_FETCH_AND_DISPATCH
+
+      // 6502 instruction emulation is generated by an M4 macro file
+      #include "M6502.ins"
+
+    op_illegal:
+      // Oops, illegal instruction executed so set fatal error flag
+      myExecutionStatus |= FatalErrorBit;
+      myTotalInstructionCount++;
+      --number;
+
+    done:
+      ;
+
+      #undef M6502_FETCH_AND_DISPATCH
+      #undef M6502_CASE
+      #undef M6502_END_CASE
+    }
+#else
     for(; !myExecutionStatus && (number != 0); --number)
     {
       uInt16 operandAddress = 0, intermediateAddress = 0;
@@ -157,7 +281,7 @@ bool M6502::execute(uInt32 number)
       myLastPeekAddress = myLastPokeAddress = myDataAddressForPoke = 0;
 
       // Fetch instruction at the program counter
-      IR = peek(PC++, DISASM_CODE);  // This address represents a code section
+      IR = fetch<countAccesses>(PC++);  // This address represents a code section
 
       // Call code to execute the instruction
       switch(IR)
@@ -171,6 +295,10 @@ bool M6502::execute(uInt32 number)
       }
       myTotalInstructionCount++;
     }
+#endif
+
+    #undef M6502_PEEK
+    #undef M6502_POKE
 
     // See if we need to handle an interrupt
     if((myExecutionStatus & MaskableInterruptBit) || 
@@ -237,7 +365,7 @@ bool M6502::save(Serializer& out) const
   const string& CPU = name();
 
   {
-    out.putString(CPU);
+    out.putTag(CPU);
 
     out.putByte(A);    // Accumulator
     out.putByte(X);    // X index register
@@ -278,7 +406,7 @@ bool M6502::load(Serializer& in)
   const string& CPU = name();
 
   {
-    if(in.getString() != CPU)
+    if(!in.getTag(CPU))
       return false;
 
     A = in.getByte();    // Accumulator
@@ -170,6 +170,16 @@ class M6502 : public Serializable
     */
     uInt32 distinctAccesses() const { return myNumberOfDistinctAccesses; }
 
+    /**
+      Enable or disable counting of memory accesses to distinct memory
+      locations (see distinctAccesses()).  This is only required by the
+      Supercharger, so is disabled by default to keep it out of the
+      peek/poke path for all other cartridges.
+
+      @param enable  Whether distinct accesses should be counted
+    */
+    void countDistinctAccesses(bool enable) { myCountDistinctAccesses = enable; }
+
     /**
       Saves the current state of this device to the given Serializer.
 
@@ -194,6 +204,17 @@ class M6502 : public Serializable
     string name() const { return "M6502"; }
 
   private:
+    /**
+      Execute instructions until the specified number of instructions
+      is executed, someone stops execution, or an error occurs.  The
+      template parameter selects whether distinct accesses are counted.
+
+      @param number Indicates the number of instructions to execute
+      @return true iff execution stops normally
+    */
+    template<bool countAccesses>
+    bool executeInstructions(uInt32 number);
+
     /**
       Get the byte at the specified address and update the cycle count.
       Addresses marked as code are hints to the debugger/disassembler to
@@ -206,8 +227,21 @@ class M6502 : public Serializable
 
       @return The byte at the specified address
     */
+    template<bool countAccesses>
     uInt8 peek(uInt16 address, uInt8 flags);
 
+    /**
+      Get the opcode or operand byte at the specified address and update
+      the cycle count.  This is peek() for code, which goes through
+      System::fetch() so consecutive fetches from the same page are cheap.
+
+      @param address  The address from which the code should be loaded
+
+      @return The byte at the specified address
+    */
+    template<bool countAccesses>
+    uInt8 fetch(uInt16 address);
+
     /**
       Change the byte at the specified address to the given value and
       update the cycle count.
@@ -215,6 +249,7 @@ class M6502 : public Serializable
       @param address  The address where the value should be stored
       @param value    The value to be stored at the address
     */
+    template<bool countAccesses>
     void poke(uInt16 address, uInt8 value);
 
     /**
@@ -310,6 +345,9 @@ class M6502 : public Serializable
     /// Indicates the last address which was accessed
     uInt16 myLastAddress;
 
+    /// Indicates whether distinct accesses are being counted
+    bool myCountDistinctAccesses;
+
     /// Indicates the last address which was accessed specifically
     /// by a peek or poke command
     uInt16 myLastPeekAddress, myLastPokeAddress;
@@ -40,7 +40,7 @@ M6532::~M6532()
 void M6532::reset()
 {
   // Initialize the 128 bytes of memory
-  if(mySettings.getBool("ramrandom"))
+  if(mySettings.getBool(Settings::RAMRandom))
     for(uInt32 t = 0; t < 128; ++t)
       myRAM[t] = mySystem->randGenerator().next();
   else
@@ -329,7 +329,7 @@ void M6532::setPinState(bool swcha)
 bool M6532::save(Serializer& out) const
 {
   {
-    out.putString(name());
+    out.putTag(name());
 
     out.putByteArray(myRAM, 128);
 
@@ -355,7 +355,7 @@ bool M6532::save(Serializer& out) const
 bool M6532::load(Serializer& in)
 {
   {
-    if(in.getString() != name())
+    if(!in.getTag(name()))
       return false;
 
     in.getByteArray(myRAM, 128);
@@ -22,6 +22,11 @@
 
 #include "MD5.hxx"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define MD5_SSE2
+#endif
+
 /*
  Copyright (C) 1991-2, RSA Data Security, Inc. Created 1991. All 
  rights reserved.
@@ -45,19 +50,6 @@
  documentation and/or software.
 */
 
-// Setup the types used by the MD5 routines
-typedef unsigned char* POINTER;
-typedef uInt16 UINT2;
-typedef uInt32 UINT4;
-
-// MD5 context.
-typedef struct 
-{
-  UINT4 state[4];                                   /* state (ABCD) */
-  UINT4 count[2];        /* number of bits, modulo 2^64 (lsb first) */
-  unsigned char buffer[64];                         /* input buffer */
-} MD5_CTX;
-
 // Constants for MD5Transform routine.
 #define S11 7
 #define S12 12
@@ -76,23 +68,18 @@ typedef struct
 #define S43 15
 #define S44 21
 
-static void MD5Init(MD5_CTX*);
-static void MD5Update(MD5_CTX*, const unsigned char*, unsigned int);
-static void MD5Final(unsigned char[16], MD5_CTX*);
-static void MD5Transform(UINT4 [4], const unsigned char [64]);
-static void Encode(unsigned char*, UINT4*, unsigned int);
-static void Decode(UINT4*, const unsigned char*, unsigned int);
-static void MD5_memcpy(POINTER, POINTER, unsigned int);
-static void MD5_memset(POINTER, int, unsigned int);
-
-static unsigned char PADDING[64] = {
+static const uInt8 PADDING[64] = {
   0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 };
 
 // F, G, H and I are basic MD5 functions.
-#define F(x, y, z) (((x) & (y)) | ((~x) & (z)))
+// F is written to need one operation less than (x & y) | (~x & z), and
+// the two halves of G never overlap, so they can be added to the sum
+// separately; in GG, the half not involving b (computed in the previous
+// step) is then ready early.  The results are identical.
+#define F(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
 #define G(x, y, z) (((x) & (z)) | ((y) & (~z)))
 #define H(x, y, z) ((x) ^ (y) ^ (z))
 #define I(x, y, z) ((y) ^ ((x) | (~z)))
@@ -103,245 +90,334 @@ static unsigned char PADDING[64] = {
 // FF, GG, HH, and II transformations for rounds 1, 2, 3, and 4.
 // Rotation is separate from addition to prevent recomputation.
 #define FF(a, b, c, d, x, s, ac) { \
- (a) += F ((b), (c), (d)) + (x) + (UINT4)(ac); \
+ (a) += F ((b), (c), (d)) + (x) + (uInt32)(ac); \
  (a) = ROTATE_LEFT ((a), (s)); \
  (a) += (b); \
   }
 #define GG(a, b, c, d, x, s, ac) { \
- (a) += G ((b), (c), (d)) + (x) + (UINT4)(ac); \
+ (a) += ((c) & (~d)) + (x) + (uInt32)(ac); \
+ (a) += (b) & (d); \
  (a) = ROTATE_LEFT ((a), (s)); \
  (a) += (b); \
   }
 #define HH(a, b, c, d, x, s, ac) { \
- (a) += H ((b), (c), (d)) + (x) + (UINT4)(ac); \
+ (a) += H ((b), (c), (d)) + (x) + (uInt32)(ac); \
  (a) = ROTATE_LEFT ((a), (s)); \
  (a) += (b); \
   }
 #define II(a, b, c, d, x, s, ac) { \
- (a) += I ((b), (c), (d)) + (x) + (UINT4)(ac); \
+ (a) += I ((b), (c), (d)) + (x) + (uInt32)(ac); \
  (a) = ROTATE_LEFT ((a), (s)); \
  (a) += (b); \
   }
 
-// MD5 initialization. Begins an MD5 operation, writing a new context.
-static void MD5Init(MD5_CTX* context)
-{
-  context->count[0] = context->count[1] = 0;
-  /* Load magic initialization constants. */
-  context->state[0] = 0x67452301;
-  context->state[1] = 0xefcdab89;
-  context->state[2] = 0x98badcfe;
-  context->state[3] = 0x10325476;
-}
+// The 64 steps of the transformation, in terms of the given FF, GG, HH
+// and II operations on a, b, c, d and x, so that the transform working
+// on four messages at once can share them
+#define MD5_STEPS(FF, GG, HH, II) \
+  /* Round 1 */ \
+  FF (a, b, c, d, x[ 0], S11, 0xd76aa478); /* 1 */ \
+  FF (d, a, b, c, x[ 1], S12, 0xe8c7b756); /* 2 */ \
+  FF (c, d, a, b, x[ 2], S13, 0x242070db); /* 3 */ \
+  FF (b, c, d, a, x[ 3], S14, 0xc1bdceee); /* 4 */ \
+  FF (a, b, c, d, x[ 4], S11, 0xf57c0faf); /* 5 */ \
+  FF (d, a, b, c, x[ 5], S12, 0x4787c62a); /* 6 */ \
+  FF (c, d, a, b, x[ 6], S13, 0xa8304613); /* 7 */ \
+  FF (b, c, d, a, x[ 7], S14, 0xfd469501); /* 8 */ \
+  FF (a, b, c, d, x[ 8], S11, 0x698098d8); /* 9 */ \
+  FF (d, a, b, c, x[ 9], S12, 0x8b44f7af); /* 10 */ \
+  FF (c, d, a, b, x[10], S13, 0xffff5bb1); /* 11 */ \
+  FF (b, c, d, a, x[11], S14, 0x895cd7be); /* 12 */ \
+  FF (a, b, c, d, x[12], S11, 0x6b901122); /* 13 */ \
+  FF (d, a, b, c, x[13], S12, 0xfd987193); /* 14 */ \
+  FF (c, d, a, b, x[14], S13, 0xa679438e); /* 15 */ \
+  FF (b, c, d, a, x[15], S14, 0x49b40821); /* 16 */ \
+  \
+  /* Round 2 */ \
+  GG (a, b, c, d, x[ 1], S21, 0xf61e2562); /* 17 */ \
+  GG (d, a, b, c, x[ 6], S22, 0xc040b340); /* 18 */ \
+  GG (c, d, a, b, x[11], S23, 0x265e5a51); /* 19 */ \
+  GG (b, c, d, a, x[ 0], S24, 0xe9b6c7aa); /* 20 */ \
+  GG (a, b, c, d, x[ 5], S21, 0xd62f105d); /* 21 */ \
+  GG (d, a, b, c, x[10], S22,  0x2441453); /* 22 */ \
+  GG (c, d, a, b, x[15], S23, 0xd8a1e681); /* 23 */ \
+  GG (b, c, d, a, x[ 4], S24, 0xe7d3fbc8); /* 24 */ \
+  GG (a, b, c, d, x[ 9], S21, 0x21e1cde6); /* 25 */ \
+  GG (d, a, b, c, x[14], S22, 0xc33707d6); /* 26 */ \
+  GG (c, d, a, b, x[ 3], S23, 0xf4d50d87); /* 27 */ \
+  GG (b, c, d, a, x[ 8], S24, 0x455a14ed); /* 28 */ \
+  GG (a, b, c, d, x[13], S21, 0xa9e3e905); /* 29 */ \
+  GG (d, a, b, c, x[ 2], S22, 0xfcefa3f8); /* 30 */ \
+  GG (c, d, a, b, x[ 7], S23, 0x676f02d9); /* 31 */ \
+  GG (b, c, d, a, x[12], S24, 0x8d2a4c8a); /* 32 */ \
+  \
+  /* Round 3 */ \
+  HH (a, b, c, d, x[ 5], S31, 0xfffa3942); /* 33 */ \
+  HH (d, a, b, c, x[ 8], S32, 0x8771f681); /* 34 */ \
+  HH (c, d, a, b, x[11], S33, 0x6d9d6122); /* 35 */ \
+  HH (b, c, d, a, x[14], S34, 0xfde5380c); /* 36 */ \
+  HH (a, b, c, d, x[ 1], S31, 0xa4beea44); /* 37 */ \
+  HH (d, a, b, c, x[ 4], S32, 0x4bdecfa9); /* 38 */ \
+  HH (c, d, a, b, x[ 7], S33, 0xf6bb4b60); /* 39 */ \
+  HH (b, c, d, a, x[10], S34, 0xbebfbc70); /* 40 */ \
+  HH (a, b, c, d, x[13], S31, 0x289b7ec6); /* 41 */ \
+  HH (d, a, b, c, x[ 0], S32, 0xeaa127fa); /* 42 */ \
+  HH (c, d, a, b, x[ 3], S33, 0xd4ef3085); /* 43 */ \
+  HH (b, c, d, a, x[ 6], S34,  0x4881d05); /* 44 */ \
+  HH (a, b, c, d, x[ 9], S31, 0xd9d4d039); /* 45 */ \
+  HH (d, a, b, c, x[12], S32, 0xe6db99e5); /* 46 */ \
+  HH (c, d, a, b, x[15], S33, 0x1fa27cf8); /* 47 */ \
+  HH (b, c, d, a, x[ 2], S34, 0xc4ac5665); /* 48 */ \
+  \
+  /* Round 4 */ \
+  II (a, b, c, d, x[ 0], S41, 0xf4292244); /* 49 */ \
+  II (d, a, b, c, x[ 7], S42, 0x432aff97); /* 50 */ \
+  II (c, d, a, b, x[14], S43, 0xab9423a7); /* 51 */ \
+  II (b, c, d, a, x[ 5], S44, 0xfc93a039); /* 52 */ \
+  II (a, b, c, d, x[12], S41, 0x655b59c3); /* 53 */ \
+  II (d, a, b, c, x[ 3], S42, 0x8f0ccc92); /* 54 */ \
+  II (c, d, a, b, x[10], S43, 0xffeff47d); /* 55 */ \
+  II (b, c, d, a, x[ 1], S44, 0x85845dd1); /* 56 */ \
+  II (a, b, c, d, x[ 8], S41, 0x6fa87e4f); /* 57 */ \
+  II (d, a, b, c, x[15], S42, 0xfe2ce6e0); /* 58 */ \
+  II (c, d, a, b, x[ 6], S43, 0xa3014314); /* 59 */ \
+  II (b, c, d, a, x[13], S44, 0x4e0811a1); /* 60 */ \
+  II (a, b, c, d, x[ 4], S41, 0xf7537e82); /* 61 */ \
+  II (d, a, b, c, x[11], S42, 0xbd3af235); /* 62 */ \
+  II (c, d, a, b, x[ 2], S43, 0x2ad7d2bb); /* 63 */ \
+  II (b, c, d, a, x[ 9], S44, 0xeb86d391); /* 64 */
 
-// MD5 block update operation. Continues an MD5 message-digest
-// operation, processing another message block, and updating the
-// context.
-static void MD5Update(MD5_CTX* context, const unsigned char* input, 
-    unsigned int inputLen)
+// MD5 basic transformation. Transforms state based on each of the
+// given number of consecutive 64-byte blocks; the state is kept in
+// registers from one block to the next.
+static void MD5Transform(uInt32 state[4], const uInt8* block, uInt32 blocks)
 {
-  unsigned int i, index, partLen;
-
-  /* Compute number of bytes mod 64 */
-  index = (unsigned int)((context->count[0] >> 3) & 0x3F);
+  uInt32 a = state[0], b = state[1], c = state[2], d = state[3], x[16];
 
-  /* Update number of bits */
-  if ((context->count[0] += ((UINT4)inputLen << 3))
-   < ((UINT4)inputLen << 3))
-    context->count[1]++;
-  context->count[1] += ((UINT4)inputLen >> 29);
-
-  partLen = 64 - index;
+  for(; blocks > 0; --blocks, block += 64)
+  {
+    const uInt32 aa = a, bb = b, cc = c, dd = d;
+
+#ifdef MSB_FIRST
+    for(int i = 0; i < 16; ++i)
+      x[i] = ((uInt32)block[i*4])          | (((uInt32)block[i*4+1]) << 8) |
+             (((uInt32)block[i*4+2]) << 16) | (((uInt32)block[i*4+3]) << 24);
+#else
+    memcpy(x, block, 64);
+#endif
+
+    MD5_STEPS(FF, GG, HH, II)
+
+    a += aa;
+    b += bb;
+    c += cc;
+    d += dd;
+  }
 
-  /* Transform as many times as possible. */
-  if (inputLen >= partLen) {
- MD5_memcpy ((POINTER)&context->buffer[index], (POINTER)input, partLen);
- MD5Transform (context->state, context->buffer);
+  state[0] = a;
+  state[1] = b;
+  state[2] = c;
+  state[3] = d;
+}
 
- for (i = partLen; i + 63 < inputLen; i += 64)
-   MD5Transform (context->state, &input[i]);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+#ifdef MD5_SSE2
+// The basic MD5 functions and transformations as above, working on four
+// 32-bit values at a time
+#define VF(x, y, z) _mm_xor_si128((z), _mm_and_si128((x), _mm_xor_si128((y), (z))))
+#define VG(x, y, z) _mm_or_si128(_mm_and_si128((x), (z)), _mm_andnot_si128((z), (y)))
+#define VH(x, y, z) _mm_xor_si128(_mm_xor_si128((x), (y)), (z))
+#define VI(x, y, z) _mm_xor_si128((y), _mm_or_si128((x), _mm_xor_si128((z), ones)))
+
+#define VSTEP(f, a, b, c, d, x, s, ac) { \
+ (a) = _mm_add_epi32((a), _mm_add_epi32(f ((b), (c), (d)), \
+                          _mm_add_epi32((x), _mm_set1_epi32((int)(ac))))); \
+ (a) = _mm_or_si128(_mm_slli_epi32((a), (s)), _mm_srli_epi32((a), 32-(s))); \
+ (a) = _mm_add_epi32((a), (b)); \
+  }
+#define VFF(a, b, c, d, x, s, ac) VSTEP(VF, a, b, c, d, x, s, ac)
+#define VGG(a, b, c, d, x, s, ac) VSTEP(VG, a, b, c, d, x, s, ac)
+#define VHH(a, b, c, d, x, s, ac) VSTEP(VH, a, b, c, d, x, s, ac)
+#define VII(a, b, c, d, x, s, ac) VSTEP(VI, a, b, c, d, x, s, ac)
+
+// MD5 basic transformation of four messages at once, each in its own
+// 32-bit lane of the state.  Transforms the state based on each of the
+// given number of consecutive 64-byte blocks of every message.
+static void MD5Transform4(__m128i state[4], const uInt8* const block[4],
+                          uInt32 blocks)
+{
+  const __m128i ones = _mm_set1_epi32(-1);
+  __m128i a = state[0], b = state[1], c = state[2], d = state[3], x[16];
 
- index = 0;
+  for(uInt32 offset = 0; blocks > 0; --blocks, offset += 64)
+  {
+    const __m128i aa = a, bb = b, cc = c, dd = d;
+
+    // Load four words of each message at a time, then transpose them so
+    // that x[i] holds word i of all four messages
+    for(int i = 0; i < 16; i += 4)
+    {
+      __m128i r0 = _mm_loadu_si128((const __m128i*)(block[0] + offset + i*4));
+      __m128i r1 = _mm_loadu_si128((const __m128i*)(block[1] + offset + i*4));
+      __m128i r2 = _mm_loadu_si128((const __m128i*)(block[2] + offset + i*4));
+      __m128i r3 = _mm_loadu_si128((const __m128i*)(block[3] + offset + i*4));
+      __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+      __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+      __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+      __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+      x[i]   = _mm_unpacklo_epi64(t0, t1);
+      x[i+1] = _mm_unpackhi_epi64(t0, t1);
+      x[i+2] = _mm_unpacklo_epi64(t2, t3);
+      x[i+3] = _mm_unpackhi_epi64(t2, t3);
+    }
+
+    MD5_STEPS(VFF, VGG, VHH, VII)
+
+    a = _mm_add_epi32(a, aa);
+    b = _mm_add_epi32(b, bb);
+    c = _mm_add_epi32(c, cc);
+    d = _mm_add_epi32(d, dd);
   }
-  else
- i = 0;
 
-  /* Buffer remaining input */
-  MD5_memcpy((POINTER)&context->buffer[index], (POINTER)&input[i], inputLen-i);
+  state[0] = a;
+  state[1] = b;
+  state[2] = c;
+  state[3] = d;
 }
+#endif
 
-// MD5 finalization. Ends an MD5 message-digest operation, writing the
-// the message digest and zeroizing the context.
-static void MD5Final(unsigned char digest[16], MD5_CTX* context)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Finish a message, of which 'total' bytes are passed in all: transform
+// the whole blocks left in the given data, then pad the rest out to 56
+// mod 64 and append the length of the message (before padding) in bits,
+// least significant byte first.  Answers the digest.
+static string MD5Final(uInt32 state[4], const uInt8* buffer, uInt32 length,
+                       uInt64 total)
 {
-  unsigned char bits[8];
-  unsigned int index, padLen;
+  MD5Transform(state, buffer, length >> 6);
+
+  uInt8 tail[128];
+  uInt32 index = length & 0x3f;
+  uInt32 padLen = (index < 56) ? (56 - index) : (120 - index);
+  memcpy(tail, buffer + (length & ~0x3f), index);
+  memcpy(tail + index, PADDING, padLen);
 
-  /* Save number of bits */
-  Encode (bits, context->count, 8);
+  uInt64 count = total << 3;
+  for(int i = 0; i < 8; ++i)
+    tail[index + padLen + i] = (uInt8)(count >> (i * 8));
 
-  /* Pad out to 56 mod 64. */
-  index = (unsigned int)((context->count[0] >> 3) & 0x3f);
-  padLen = (index < 56) ? (56 - index) : (120 - index);
-  MD5Update (context, PADDING, padLen);
+  MD5Transform(state, tail, (index + padLen + 8) >> 6);
 
-  /* Append length (before padding) */
-  MD5Update (context, bits, 8);
-  /* Store state in digest */
-  Encode (digest, context->state, 16);
+  static const char hex[] = "0123456789abcdef";
+  char digest[32];
+  for(int t = 0; t < 16; ++t)
+  {
+    uInt8 byte = (uInt8)(state[t >> 2] >> ((t & 3) * 8));
+    digest[t*2]   = hex[byte >> 4];
+    digest[t*2+1] = hex[byte & 0x0f];
+  }
 
-  /* Zeroize sensitive information. */
-  MD5_memset ((POINTER)context, 0, sizeof (*context));
+  return string(digest, 32);
 }
 
-// MD5 basic transformation. Transforms state based on block.
-static void MD5Transform(UINT4 state[4], const unsigned char block[64])
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string MD5(const uInt8* buffer, uInt32 length)
 {
-  UINT4 a = state[0], b = state[1], c = state[2], d = state[3], x[16];
-
-  Decode (x, block, 64);
-
-  /* Round 1 */
-  FF (a, b, c, d, x[ 0], S11, 0xd76aa478); /* 1 */
-  FF (d, a, b, c, x[ 1], S12, 0xe8c7b756); /* 2 */
-  FF (c, d, a, b, x[ 2], S13, 0x242070db); /* 3 */
-  FF (b, c, d, a, x[ 3], S14, 0xc1bdceee); /* 4 */
-  FF (a, b, c, d, x[ 4], S11, 0xf57c0faf); /* 5 */
-  FF (d, a, b, c, x[ 5], S12, 0x4787c62a); /* 6 */
-  FF (c, d, a, b, x[ 6], S13, 0xa8304613); /* 7 */
-  FF (b, c, d, a, x[ 7], S14, 0xfd469501); /* 8 */
-  FF (a, b, c, d, x[ 8], S11, 0x698098d8); /* 9 */
-  FF (d, a, b, c, x[ 9], S12, 0x8b44f7af); /* 10 */
-  FF (c, d, a, b, x[10], S13, 0xffff5bb1); /* 11 */
-  FF (b, c, d, a, x[11], S14, 0x895cd7be); /* 12 */
-  FF (a, b, c, d, x[12], S11, 0x6b901122); /* 13 */
-  FF (d, a, b, c, x[13], S12, 0xfd987193); /* 14 */
-  FF (c, d, a, b, x[14], S13, 0xa679438e); /* 15 */
-  FF (b, c, d, a, x[15], S14, 0x49b40821); /* 16 */
-
-  /* Round 2 */
-  GG (a, b, c, d, x[ 1], S21, 0xf61e2562); /* 17 */
-  GG (d, a, b, c, x[ 6], S22, 0xc040b340); /* 18 */
-  GG (c, d, a, b, x[11], S23, 0x265e5a51); /* 19 */
-  GG (b, c, d, a, x[ 0], S24, 0xe9b6c7aa); /* 20 */
-  GG (a, b, c, d, x[ 5], S21, 0xd62f105d); /* 21 */
-  GG (d, a, b, c, x[10], S22,  0x2441453); /* 22 */
-  GG (c, d, a, b, x[15], S23, 0xd8a1e681); /* 23 */
-  GG (b, c, d, a, x[ 4], S24, 0xe7d3fbc8); /* 24 */
-  GG (a, b, c, d, x[ 9], S21, 0x21e1cde6); /* 25 */
-  GG (d, a, b, c, x[14], S22, 0xc33707d6); /* 26 */
-  GG (c, d, a, b, x[ 3], S23, 0xf4d50d87); /* 27 */
-  GG (b, c, d, a, x[ 8], S24, 0x455a14ed); /* 28 */
-  GG (a, b, c, d, x[13], S21, 0xa9e3e905); /* 29 */
-  GG (d, a, b, c, x[ 2], S22, 0xfcefa3f8); /* 30 */
-  GG (c, d, a, b, x[ 7], S23, 0x676f02d9); /* 31 */
-  GG (b, c, d, a, x[12], S24, 0x8d2a4c8a); /* 32 */
-
-  /* Round 3 */
-  HH (a, b, c, d, x[ 5], S31, 0xfffa3942); /* 33 */
-  HH (d, a, b, c, x[ 8], S32, 0x8771f681); /* 34 */
-  HH (c, d, a, b, x[11], S33, 0x6d9d6122); /* 35 */
-  HH (b, c, d, a, x[14], S34, 0xfde5380c); /* 36 */
-  HH (a, b, c, d, x[ 1], S31, 0xa4beea44); /* 37 */
-  HH (d, a, b, c, x[ 4], S32, 0x4bdecfa9); /* 38 */
-  HH (c, d, a, b, x[ 7], S33, 0xf6bb4b60); /* 39 */
-  HH (b, c, d, a, x[10], S34, 0xbebfbc70); /* 40 */
-  HH (a, b, c, d, x[13], S31, 0x289b7ec6); /* 41 */
-  HH (d, a, b, c, x[ 0], S32, 0xeaa127fa); /* 42 */
-  HH (c, d, a, b, x[ 3], S33, 0xd4ef3085); /* 43 */
-  HH (b, c, d, a, x[ 6], S34,  0x4881d05); /* 44 */
-  HH (a, b, c, d, x[ 9], S31, 0xd9d4d039); /* 45 */
-  HH (d, a, b, c, x[12], S32, 0xe6db99e5); /* 46 */
-  HH (c, d, a, b, x[15], S33, 0x1fa27cf8); /* 47 */
-  HH (b, c, d, a, x[ 2], S34, 0xc4ac5665); /* 48 */
-
-  /* Round 4 */
-  II (a, b, c, d, x[ 0], S41, 0xf4292244); /* 49 */
-  II (d, a, b, c, x[ 7], S42, 0x432aff97); /* 50 */
-  II (c, d, a, b, x[14], S43, 0xab9423a7); /* 51 */
-  II (b, c, d, a, x[ 5], S44, 0xfc93a039); /* 52 */
-  II (a, b, c, d, x[12], S41, 0x655b59c3); /* 53 */
-  II (d, a, b, c, x[ 3], S42, 0x8f0ccc92); /* 54 */
-  II (c, d, a, b, x[10], S43, 0xffeff47d); /* 55 */
-  II (b, c, d, a, x[ 1], S44, 0x85845dd1); /* 56 */
-  II (a, b, c, d, x[ 8], S41, 0x6fa87e4f); /* 57 */
-  II (d, a, b, c, x[15], S42, 0xfe2ce6e0); /* 58 */
-  II (c, d, a, b, x[ 6], S43, 0xa3014314); /* 59 */
-  II (b, c, d, a, x[13], S44, 0x4e0811a1); /* 60 */
-  II (a, b, c, d, x[ 4], S41, 0xf7537e82); /* 61 */
-  II (d, a, b, c, x[11], S42, 0xbd3af235); /* 62 */
-  II (c, d, a, b, x[ 2], S43, 0x2ad7d2bb); /* 63 */
-  II (b, c, d, a, x[ 9], S44, 0xeb86d391); /* 64 */
+  // Load magic initialization constants
+  uInt32 state[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
 
-  state[0] += a;
-  state[1] += b;
-  state[2] += c;
-  state[3] += d;
-
-  /* Zeroize sensitive information. */
-  MD5_memset ((POINTER)x, 0, sizeof (x));
+  // All whole blocks are transformed straight from the input
+  return MD5Final(state, buffer, length, length);
 }
 
-// Encodes input (UINT4) into output (unsigned char). Assumes len is
-// a multiple of 4.
-static void Encode(unsigned char* output, UINT4* input, unsigned int len)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MD5(const uInt8* const* buffers, const uInt32* lengths, uInt32 count,
+         string* digests)
 {
-  unsigned int i, j;
+  uInt32 i = 0;
 
-  for (i = 0, j = 0; j < len; i++, j += 4) {
- output[j] = (unsigned char)(input[i] & 0xff);
- output[j+1] = (unsigned char)((input[i] >> 8) & 0xff);
- output[j+2] = (unsigned char)((input[i] >> 16) & 0xff);
- output[j+3] = (unsigned char)((input[i] >> 24) & 0xff);
+#ifdef MD5_SSE2
+  // Hash four messages side by side as long as all of them have whole
+  // blocks left, then finish each one on its own
+  for(; i + 4 <= count; i += 4)
+  {
+    uInt32 blocks = lengths[i] >> 6;
+    for(uInt32 k = 1; k < 4; ++k)
+      blocks = std::min(blocks, lengths[i + k] >> 6);
+
+    __m128i state4[4] = {
+      _mm_set1_epi32(0x67452301), _mm_set1_epi32((int)0xefcdab89),
+      _mm_set1_epi32((int)0x98badcfe), _mm_set1_epi32(0x10325476)
+    };
+    MD5Transform4(state4, buffers + i, blocks);
+
+    uInt32 lanes[4][4];
+    for(uInt32 j = 0; j < 4; ++j)
+      _mm_storeu_si128((__m128i*)lanes[j], state4[j]);
+
+    for(uInt32 k = 0; k < 4; ++k)
+    {
+      uInt32 state[4] = { lanes[0][k], lanes[1][k], lanes[2][k], lanes[3][k] };
+      uInt32 done = blocks << 6;
+      digests[i + k] = MD5Final(state, buffers[i + k] + done,
+                                lengths[i + k] - done, lengths[i + k]);
+    }
   }
-}
-
-// Decodes input (unsigned char) into output (UINT4). Assumes len is
-// a multiple of 4.
-static void Decode(UINT4* output, const unsigned char* input, unsigned int len)
-{
-  unsigned int i, j;
+#endif
 
-  for (i = 0, j = 0; j < len; i++, j += 4)
- output[i] = ((UINT4)input[j]) | (((UINT4)input[j+1]) << 8) |
-   (((UINT4)input[j+2]) << 16) | (((UINT4)input[j+3]) << 24);
+  for(; i < count; ++i)
+    digests[i] = MD5(buffers[i], lengths[i]);
 }
 
-// Note: Replace "for loop" with standard memcpy if possible.
-static void MD5_memcpy(POINTER output, POINTER input, unsigned int len)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MD5Context::MD5Context()
 {
-  unsigned int i;
-
-  for (i = 0; i < len; i++)
- output[i] = input[i];
+  reset();
 }
 
-// Note: Replace "for loop" with standard memset if possible.
-static void MD5_memset(POINTER output, int value, unsigned int len)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MD5Context::reset()
 {
-  unsigned int i;
-
-  for (i = 0; i < len; i++)
- ((char *)output)[i] = (char)value;
+  // Load magic initialization constants
+  myState[0] = 0x67452301;
+  myState[1] = 0xefcdab89;
+  myState[2] = 0x98badcfe;
+  myState[3] = 0x10325476;
+  myLength = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string MD5(const uInt8* buffer, uInt32 length)
+void MD5Context::update(const uInt8* buffer, uInt32 length)
 {
-  char hex[] = "0123456789abcdef";
-  MD5_CTX context;
-  unsigned char md5[16];
+  uInt32 index = (uInt32)(myLength & 0x3f);
+  myLength += length;
 
-  MD5Init(&context);
-  MD5Update(&context, buffer, length);
-  MD5Final(md5, &context);
-
-  string result;
-  for(int t = 0; t < 16; ++t)
+  // Complete any partial block left over from last time
+  if(index > 0)
   {
-    result += hex[(md5[t] >> 4) & 0x0f];
-    result += hex[md5[t] & 0x0f];
+    uInt32 partLen = 64 - index;
+    if(length < partLen)
+    {
+      memcpy(myBuffer + index, buffer, length);
+      return;
+    }
+    memcpy(myBuffer + index, buffer, partLen);
+    MD5Transform(myState, myBuffer, 1);
+    buffer += partLen;
+    length -= partLen;
   }
 
-  return result;
+  // Transform all whole blocks straight from the input, and buffer the rest
+  MD5Transform(myState, buffer, length >> 6);
+  memcpy(myBuffer, buffer + (length & ~0x3f), length & 0x3f);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string MD5Context::result()
+{
+  string digest = MD5Final(myState, myBuffer, (uInt32)(myLength & 0x3f),
+                           myLength);
+  reset();
+
+  return digest;
 }
@@ -32,5 +32,63 @@
 */
 string MD5(const uInt8* buffer, uInt32 length);
 
+/**
+  Get the MD5 Message-Digests of several messages at once, as when
+  indexing a collection of ROMs.  Where SSE2 is available, four messages
+  are hashed side by side for as long as all of them have data left, so
+  messages of similar length gain the most.  The digests are the same
+  as those answered by MD5() for each message.
+
+  @param buffers The messages to compute the digests of
+  @param lengths The length of each message
+  @param count   The number of messages
+  @param digests Receives the message-digest of each message
+*/
+void MD5(const uInt8* const* buffers, const uInt32* lengths, uInt32 count,
+         string* digests);
+
+/**
+  Computes the MD5 Message-Digest of a message which is supplied in
+  pieces, so that an image can be hashed while it's being copied or
+  assembled.  Feeding the pieces to update() in order gives the same
+  digest as passing the whole message to MD5().
+*/
+class MD5Context
+{
+  public:
+    MD5Context();
+
+    /**
+      Start a new message, discarding any data passed so far.
+    */
+    void reset();
+
+    /**
+      Append the given data to the message.
+
+      @param buffer The data to append
+      @param length The length of the data
+    */
+    void update(const uInt8* buffer, uInt32 length);
+
+    /**
+      Finish the message and return its digest as 32 hexadecimal digits.
+      The context is reset afterwards, ready for a new message.
+
+      @return The message-digest
+    */
+    string result();
+
+  private:
+    // Message-digest state (ABCD)
+    uInt32 myState[4];
+
+    // Number of bytes of the message passed so far
+    uInt64 myLength;
+
+    // Data not yet transformed, since it doesn't fill a 64-byte block
+    uInt8 myBuffer[64];
+};
+
 
 #endif
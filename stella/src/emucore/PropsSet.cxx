@@ -79,33 +79,62 @@ bool PropertiesSet::getMD5(const string& md5, Properties& properties,
   }
 
   // Otherwise, search the internal database using binary search
-  if(!found)
+  uInt64 high, low;
+  if(!found && parseMD5(md5, high, low))
   {
-    int low = 0, high = DEF_PROPS_SIZE - 1;
-    while(low <= high)
+    int first = 0, last = DEF_PROPS_SIZE - 1;
+    while(first <= last)
     {
-      int i = (low + high) / 2;
-      int cmp = BSPF_compareIgnoreCase(md5, DefProps[i][Cartridge_MD5]);
+      int i = (first + last) / 2;
+      const uInt64* key = DefPropsMD5[i];
 
-      if(cmp == 0)  // found it
+      if(high == key[0] && low == key[1])  // found it
       {
-        for(int p = 0; p < LastPropType; ++p)
-          if(DefProps[i][p][0] != 0)
-            properties.set((PropertyType)p, DefProps[i][p]);
+        string lower = md5;
+        transform(lower.begin(), lower.end(), lower.begin(),
+                  (int(*)(int)) tolower);
+        properties.set(Cartridge_MD5, lower);
+        for(int p = Cartridge_MD5 + 1; p < LastPropType; ++p)
+          if(DefProps[i][p] != 0)
+            properties.set((PropertyType)p, DefPropsStrings + DefProps[i][p]);
 
         found = true;
         break;
       }
-      else if(cmp < 0)
-        high = i - 1; // look at lower range
+      else if(high < key[0] || (high == key[0] && low < key[1]))
+        last = i - 1;   // look at lower range
       else
-        low = i + 1;  // look at upper range
+        first = i + 1;  // look at upper range
     }
   }
 
   return found;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PropertiesSet::parseMD5(const string& md5, uInt64& high, uInt64& low)
+{
+  if(md5.length() != 32)
+    return false;
+
+  uInt64 value[2] = { 0, 0 };
+  for(int i = 0; i < 32; ++i)
+  {
+    char c = md5[i];
+    uInt64 nibble;
+    if(c >= '0' && c <= '9')       nibble = c - '0';
+    else if(c >= 'a' && c <= 'f')  nibble = c - 'a' + 10;
+    else if(c >= 'A' && c <= 'F')  nibble = c - 'A' + 10;
+    else                           return false;
+
+    value[i >> 4] = (value[i >> 4] << 4) | nibble;
+  }
+  high = value[0];
+  low  = value[1];
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PropertiesSet::removeMD5(const string& md5)
 {
@@ -73,6 +73,19 @@ class PropertiesSet
     */
     void removeMD5(const string& md5);
 
+  private:
+    /**
+      Convert an md5 in hex to the binary form used as the key of the
+      built-in properties.
+
+      @param md5   The md5 as 32 hex digits (in either case)
+      @param high  The upper 64 bits of the md5
+      @param low   The lower 64 bits of the md5
+
+      @return  True if the md5 was well-formed, else false
+    */
+    static bool parseMD5(const string& md5, uInt64& high, uInt64& low);
+
   private:
     typedef map<string, Properties> PropsList;
 
@@ -0,0 +1,361 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll       
+//  SS  SS   tt           ll   ll        
+//  SS     tttttt  eeee   ll   ll   aaaa 
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include <cstring>
+
+#include "Serializer.hxx"
+#include "StateManager.hxx"
+
+#include "RewindManager.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RewindManager::RewindManager(StateManager& stateManager)
+  : myStateManager(stateManager),
+    myBuffer(0),
+    myBufferSize(0),
+    myHead(0),
+    myEntries(0),
+    myFirst(0),
+    myCount(0),
+    myBytesUsed(0),
+    myFramesSinceKey(0),
+    myStateSize(0),
+    myState(0),
+    myLast(0),
+    myEncoded(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RewindManager::~RewindManager()
+{
+  setBufferSize(0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::setBufferSize(uInt32 size)
+{
+  if(size == myBufferSize)
+    return;
+
+  delete[] myBuffer;   myBuffer = 0;
+  delete[] myEntries;  myEntries = 0;
+  allocateStates(0);
+
+  myBufferSize = size;
+  if(size > 0)
+  {
+    myBuffer  = new uInt8[size];
+    myEntries = new Entry[kMaxStates];
+  }
+
+  clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::clear()
+{
+  myHead = myFirst = myCount = myBytesUsed = 0;
+  myFramesSinceKey = 0;
+
+  // The state size is measured again when the next state is added,
+  // since a different cart may have been loaded in the meantime
+  allocateStates(0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::allocateStates(uInt32 stateSize)
+{
+  delete[] myState;    myState = 0;
+  delete[] myLast;     myLast = 0;
+  delete[] myEncoded;  myEncoded = 0;
+
+  myStateSize = stateSize;
+  if(stateSize > 0)
+  {
+    myState   = new uInt8[stateSize];
+    myLast    = new uInt8[stateSize];
+    myEncoded = new uInt8[stateSize + stateSize / 2 + 64];
+    memset(myState, 0, stateSize);
+    memset(myLast, 0, stateSize);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::addState(uInt32 frame)
+{
+  if(!enabled())
+    return false;
+
+  while(myCount > 0 && entry(myCount - 1).frame >= frame)
+    discardNewest();
+
+  if(myStateSize == 0)
+  {
+    Serializer counter(0, 0);
+    if(!myStateManager.saveState(counter, false))
+      return false;
+    allocateStates(counter.size());
+  }
+
+  // States are only kept for rewinding during this session, so there's
+  // no need for a checksum
+  Serializer out(myState, myStateSize);
+  if(!myStateManager.saveState(out, false))
+    return false;
+
+  // The state has grown; start again from scratch
+  if(!out.isValid())
+  {
+    clear();
+    return addState(frame);
+  }
+  memset(myState + out.size(), 0, myStateSize - out.size());
+
+  if(myCount == kMaxStates)
+    discardOldest();
+
+  bool keyframe = myCount == 0 || myFramesSinceKey >= kKeyframeInterval;
+  uInt32 size = encode(myState, keyframe ? 0 : myLast, myEncoded);
+  if(size > myBufferSize)
+  {
+    clear();
+    return false;
+  }
+  uInt32 offset = allocate(size);
+
+  // Making room for the delta discarded the state it depends on
+  if(!keyframe && myCount == 0)
+  {
+    keyframe = true;
+    size = encode(myState, 0, myEncoded);
+    offset = allocate(size);
+  }
+
+  memcpy(myBuffer + offset, myEncoded, size);
+
+  Entry& e = entry(myCount++);
+  e.offset   = offset;
+  e.size     = size;
+  e.frame    = frame;
+  e.keyframe = keyframe;
+  myBytesUsed += size;
+
+  myFramesSinceKey = keyframe ? 1 : myFramesSinceKey + 1;
+
+  // The state just added is now the newest one
+  uInt8* tmp = myLast;  myLast = myState;  myState = tmp;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::rewindState()
+{
+  if(!enabled() || myCount == 0)
+    return false;
+
+  if(myCount > 1)
+    discardNewest();
+
+  Serializer in(myLast, myStateSize, true);
+  return myStateManager.loadState(in);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RewindManager::allocate(uInt32 size)
+{
+  if(myCount == 0)
+    myHead = 0;
+
+  uInt32 offset = myHead;
+
+  // Wrap around to the start of the buffer; any states between the
+  // head and the end of the buffer are the oldest ones
+  if(offset + size > myBufferSize)
+  {
+    while(myCount > 0 && entry(0).offset >= myHead)
+      discardOldest();
+    offset = 0;
+  }
+
+  // Discard the oldest states until they don't overlap the new one
+  while(myCount > 0 && entry(0).offset < offset + size &&
+        entry(0).offset + entry(0).size > offset)
+    discardOldest();
+
+  myHead = offset + size;
+  return offset;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::discardOldest()
+{
+  do
+  {
+    myBytesUsed -= entry(0).size;
+    myFirst = (myFirst + 1) % kMaxStates;
+    --myCount;
+  }
+  while(myCount > 0 && !entry(0).keyframe);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::discardNewest()
+{
+  const Entry& newest = entry(myCount - 1);
+
+  // The newest state is in myLast; XOR'ing its delta into it again
+  // gives the preceding state, otherwise the preceding state must be
+  // rebuilt from its own keyframe
+  if(myCount > 1)
+  {
+    if(newest.keyframe)
+      rebuild(myCount - 2);
+    else
+      apply(newest, myLast);
+  }
+
+  myHead = newest.offset;
+  myBytesUsed -= newest.size;
+  --myCount;
+
+  myFramesSinceKey = 0;
+  if(myCount > 0)
+  {
+    myFramesSinceKey = 1;
+    while(!entry(myCount - myFramesSinceKey).keyframe)
+      ++myFramesSinceKey;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static inline uInt8* putLength(uInt8* out, uInt32 length)
+{
+  while(length >= 0x80)
+  {
+    *out++ = (length & 0x7f) | 0x80;
+    length >>= 7;
+  }
+  *out++ = length;
+
+  return out;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static inline const uInt8* getLength(const uInt8* in, uInt32& length)
+{
+  int shift = 0;
+
+  length = 0;
+  do
+  {
+    length |= (*in & 0x7f) << shift;
+    shift += 7;
+  }
+  while(*in++ & 0x80);
+
+  return in;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RewindManager::encode(const uInt8* state, const uInt8* ref,
+                             uInt8* out) const
+{
+  // The XOR of both states is encoded as a sequence of runs, each
+  // consisting of the number of zero bytes to skip, followed by the
+  // number of literal bytes and the bytes themselves.  Literal runs
+  // only end at four or more zero bytes, since shorter zero runs
+  // would take more space to encode than they save.
+  #define XOR(_i) (ref ? state[_i] ^ ref[_i] : state[_i])
+
+  uInt8* start = out;
+  uInt32 i = 0;
+
+  while(i < myStateSize)
+  {
+    uInt32 literal = i;
+    while(literal < myStateSize && XOR(literal) == 0)
+      ++literal;
+    if(literal == myStateSize)
+      break;
+
+    uInt32 end = literal, zeros = 0;
+    while(end < myStateSize && zeros < 4)
+    {
+      zeros = XOR(end) == 0 ? zeros + 1 : 0;
+      ++end;
+    }
+    end -= zeros;
+
+    out = putLength(out, literal - i);
+    out = putLength(out, end - literal);
+    for(; literal < end; ++literal)
+      *out++ = XOR(literal);
+
+    i = end;
+  }
+
+  #undef XOR
+
+  return out - start;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::apply(const Entry& e, uInt8* state) const
+{
+  const uInt8* in  = myBuffer + e.offset;
+  const uInt8* end = in + e.size;
+  uInt32 i = 0;
+
+  while(in < end)
+  {
+    uInt32 skip, length;
+    in = getLength(in, skip);
+    in = getLength(in, length);
+
+    i += skip;
+    for(uInt32 j = 0; j < length; ++j)
+      state[i++] ^= *in++;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::rebuild(uInt32 i)
+{
+  uInt32 key = i;
+  while(!entry(key).keyframe)
+    --key;
+
+  memset(myLast, 0, myStateSize);
+  for(; key <= i; ++key)
+    apply(entry(key), myLast);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RewindManager::RewindManager(const RewindManager& other)
+  : myStateManager(other.myStateManager)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RewindManager& RewindManager::operator = (const RewindManager&)
+{
+  return *this;
+}
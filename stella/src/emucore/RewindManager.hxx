@@ -0,0 +1,184 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll       
+//  SS  SS   tt           ll   ll        
+//  SS     tttttt  eeee   ll   ll   aaaa 
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef REWIND_MANAGER_HXX
+#define REWIND_MANAGER_HXX
+
+class StateManager;
+
+#include "bspf.hxx"
+
+/**
+  This class keeps a history of recent emulation states in memory, so
+  that emulation can be rewound one frame at a time.
+
+  States are stored in a fixed size ring buffer.  Every so often a
+  keyframe is stored; all other states are stored as the XOR of the
+  state and the one preceding it, with runs of unchanged bytes
+  removed.  Since consecutive states differ very little, this takes
+  a small fraction of the space of a full state.  When the buffer is
+  full, the oldest keyframe is discarded along with all states
+  depending on it.
+
+  Stepping back from a delta only requires XOR'ing it into the newest
+  state again; stepping back over a keyframe requires replaying the
+  deltas from the previous keyframe.
+
+  @version $Id$
+*/
+class RewindManager
+{
+  public:
+    /**
+      Create a new rewind manager, which saves and loads states
+      using the given state manager
+    */
+    RewindManager(StateManager& stateManager);
+
+    /**
+      Destructor
+    */
+    virtual ~RewindManager();
+
+  public:
+    /**
+      Set the size of the ring buffer used to store states.  A size of
+      zero disables rewinding.  Any existing history is discarded when
+      the size changes.
+
+      @param size  The size of the buffer, in bytes
+    */
+    void setBufferSize(uInt32 size);
+
+    /**
+      Answers whether rewinding is enabled (ie, a buffer has been set)
+    */
+    bool enabled() const { return myBuffer != 0; }
+
+    /**
+      Add the current emulation state to the history, discarding the
+      oldest states if required.  States from the same frame or later
+      ones are discarded first; these were added before an earlier
+      state was loaded (as is done for run-ahead and netplay), and the
+      frames following it are now emulated again.
+
+      @param frame  The number of frames emulated up to this state
+
+      @return  False on any save errors, else true
+    */
+    bool addState(uInt32 frame);
+
+    /**
+      Discard the newest state in the history, and load the one
+      preceding it.  When only one state is left, it is kept and
+      loaded again.
+
+      @return  False if there is no history or on any load errors,
+               else true
+    */
+    bool rewindState();
+
+    /**
+      Discard all states in the history
+    */
+    void clear();
+
+    /**
+      Answers the number of states in the history
+    */
+    uInt32 numStates() const { return myCount; }
+
+    /**
+      Answers the number of bytes used by the states in the history
+    */
+    uInt32 bytesUsed() const { return myBytesUsed; }
+
+  private:
+    // Copy constructor isn't supported by this class so make it private
+    RewindManager(const RewindManager&);
+
+    // Assignment operator isn't supported by this class so make it private
+    RewindManager& operator = (const RewindManager&);
+
+    // Location of a stored state within the ring buffer
+    struct Entry {
+      uInt32 offset;
+      uInt32 size;
+      uInt32 frame;
+      bool keyframe;
+    };
+
+    // Answers the entry for the given state (0 being the oldest)
+    Entry& entry(uInt32 i) { return myEntries[(myFirst + i) % kMaxStates]; }
+
+    // (Re)allocate the buffers used to hold a single state
+    void allocateStates(uInt32 stateSize);
+
+    // Reserve space for a state of the given size at the head of the
+    // ring buffer, discarding the oldest states as required
+    uInt32 allocate(uInt32 size);
+
+    // Discard the oldest keyframe, and all states depending on it
+    void discardOldest();
+
+    // Discard the newest state, leaving the one preceding it in myLast
+    void discardNewest();
+
+    // Encode the XOR of 'state' and 'ref' (or just 'state' if 'ref' is
+    // NULL) into 'out', and answer the number of bytes written
+    uInt32 encode(const uInt8* state, const uInt8* ref, uInt8* out) const;
+
+    // XOR a state previously encoded with encode() into 'state'
+    void apply(const Entry& e, uInt8* state) const;
+
+    // Rebuild the given state into myLast, starting from its keyframe
+    void rebuild(uInt32 i);
+
+  private:
+    enum {
+      kKeyframeInterval = 60,           // store a keyframe every second
+      kMaxStates        = 60 * 60 * 10  // at most 10 minutes of history
+    };
+
+    // The state manager used to save and load states
+    StateManager& myStateManager;
+
+    // The ring buffer holding the encoded states
+    uInt8* myBuffer;
+    uInt32 myBufferSize;
+    uInt32 myHead;
+
+    // Location of each state in the ring buffer
+    Entry* myEntries;
+    uInt32 myFirst;
+    uInt32 myCount;
+    uInt32 myBytesUsed;
+
+    // Number of states added since the last keyframe
+    uInt32 myFramesSinceKey;
+
+    // Size of a single state, and buffers holding the state being
+    // added, the newest state in the history and an encoded state
+    uInt32 myStateSize;
+    uInt8* myState;
+    uInt8* myLast;
+    uInt8* myEncoded;
+};
+
+#endif
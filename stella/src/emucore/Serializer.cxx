@@ -18,13 +18,20 @@
 //============================================================================
 
 #include <fstream>
+#include <cstring>
 
 #include "Serializer.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Serializer::Serializer(const string& filename, bool readonly)
   : myStream(NULL),
-    myUseFilestream(true)
+    myUseFilestream(true),
+    myBuffer(NULL),
+    myBufferSize(0),
+    myPosition(0),
+    myReadOnly(readonly),
+    myOverflow(false),
+    myCompact(false)
 {
   if(readonly)
   {
@@ -69,7 +76,13 @@ Serializer::Serializer(const string& filename, bool readonly)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Serializer::Serializer(void)
   : myStream(NULL),
-    myUseFilestream(false)
+    myUseFilestream(false),
+    myBuffer(NULL),
+    myBufferSize(0),
+    myPosition(0),
+    myReadOnly(false),
+    myOverflow(false),
+    myCompact(false)
 {
   myStream = new stringstream(ios::in | ios::out | ios::binary);
   
@@ -83,6 +96,19 @@ Serializer::Serializer(void)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Serializer::Serializer(uInt8* buffer, uInt32 size, bool readonly)
+  : myStream(NULL),
+    myUseFilestream(false),
+    myBuffer(buffer),
+    myBufferSize(buffer ? size : 0),
+    myPosition(0),
+    myReadOnly(readonly),
+    myOverflow(false),
+    myCompact(false)
+{
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Serializer::~Serializer(void)
 {
@@ -99,113 +125,127 @@ Serializer::~Serializer(void)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Serializer::isValid(void)
 {
-  return myStream != NULL;
+  if(myStream != NULL)
+    return true;
+
+  // A memory block based device is valid until it overflows; a NULL
+  // block is always valid for writing, since it only counts bytes
+  return !myOverflow && (myBuffer != NULL || !myReadOnly);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::reset(void)
 {
+  myPosition = 0;
+  myOverflow = false;
+
+  if(myStream == NULL)
+    return;
+
   myStream->clear();
   myStream->seekg(ios_base::beg);
   myStream->seekp(ios_base::beg);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 Serializer::getByte(void)
+void Serializer::readDataSlow(void* data, uInt32 size)
 {
-  char buf;
-  myStream->read(&buf, 1);
+  if(myStream != NULL)
+  {
+    myStream->read((char*)data, size);
+    return;
+  }
 
-  return buf;
-}
+  if(myOverflow || myBuffer == NULL || size > myBufferSize - myPosition)
+  {
+    myOverflow = true;
+    memset(data, 0, size);
+    return;
+  }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::getByteArray(uInt8* array, uInt32 size)
-{
-  myStream->read((char*)array, size);
+  memcpy(data, myBuffer + myPosition, size);
+  myPosition += size;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt16 Serializer::getShort(void)
+void Serializer::writeDataSlow(const void* data, uInt32 size)
 {
-  uInt16 val = 0;
-  myStream->read((char*)&val, sizeof(uInt16));
+  if(myStream != NULL)
+  {
+    myStream->write((const char*)data, size);
+    return;
+  }
 
-  return val;
+  if(myBuffer == NULL && !myReadOnly)
+  {
+    // Only count the number of bytes written
+    myPosition += size;
+    return;
+  }
+
+  if(myOverflow || myReadOnly || size > myBufferSize - myPosition)
+  {
+    myOverflow = true;
+    return;
+  }
+
+  memcpy(myBuffer + myPosition, data, size);
+  myPosition += size;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::getShortArray(uInt16* array, uInt32 size)
+void Serializer::getByteArray(uInt8* array, uInt32 size)
 {
-  myStream->read((char*)array, sizeof(uInt16)*size);
+  readData(array, size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Serializer::getInt(void)
+void Serializer::getShortArray(uInt16* array, uInt32 size)
 {
-  uInt32 val = 0;
-  myStream->read((char*)&val, sizeof(uInt32));
-
-  return val;
+  readData(array, sizeof(uInt16)*size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::getIntArray(uInt32* array, uInt32 size)
 {
-  myStream->read((char*)array, sizeof(uInt32)*size);
+  readData(array, sizeof(uInt32)*size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Serializer::getString(void)
 {
-  int len = getInt();
+  uInt32 len = getInt();
   string str;
-  str.resize(len);
-  myStream->read(&str[0], len);
 
-  return str;
-}
+  // Guard against corrupt lengths when reading from a memory block
+  if(myStream == NULL && (myBuffer == NULL || len > myBufferSize - myPosition))
+  {
+    myOverflow = true;
+    return str;
+  }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Serializer::getBool(void)
-{
-  return getByte() == TruePattern;
-}
+  str.resize(len);
+  readData(&str[0], len);
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putByte(uInt8 value)
-{
-  myStream->write((char*)&value, 1);
+  return str;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putByteArray(const uInt8* array, uInt32 size)
 {
-  myStream->write((char*)array, size);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putShort(uInt16 value)
-{
-  myStream->write((char*)&value, sizeof(uInt16));
+  writeData(array, size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putShortArray(const uInt16* array, uInt32 size)
 {
-  myStream->write((char*)array, sizeof(uInt16)*size);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putInt(uInt32 value)
-{
-  myStream->write((char*)&value, sizeof(uInt32));
+  writeData(array, sizeof(uInt16)*size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putIntArray(const uInt32* array, uInt32 size)
 {
-  myStream->write((char*)array, sizeof(uInt32)*size);
+  writeData(array, sizeof(uInt32)*size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -213,11 +253,18 @@ void Serializer::putString(const string& str)
 {
   int len = str.length();
   putInt(len);
-  myStream->write(str.data(), len);
+  writeData(str.data(), len);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::putTag(const string& name)
+{
+  if(!myCompact)
+    putString(name);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putBool(bool b)
+bool Serializer::getTag(const string& name)
 {
-  putByte(b ? TruePattern: FalsePattern);
+  return myCompact || getString() == name;
 }
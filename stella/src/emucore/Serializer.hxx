@@ -22,6 +22,7 @@
 
 #include <iostream>
 #include <sstream>
+#include <cstring>
 #include "bspf.hxx"
 
 /**
@@ -57,6 +58,22 @@ class Serializer
     Serializer(const string& filename, bool readonly = false);
     Serializer(void);
 
+    /**
+      Creates a new Serializer device which reads from/writes to the given
+      block of memory.  No memory is allocated and no data is copied other
+      than the serialized values themselves.  Accessing data past the end
+      of the block invalidates the stream (see isValid()) instead of
+      throwing an exception; reads then return zero.
+
+      If 'buffer' is NULL, nothing is stored and the device only counts
+      the number of bytes written (see size()).
+
+      @param buffer    The memory to serialize to/from (may be NULL)
+      @param size      The size of the memory block, in bytes
+      @param readonly  If true, the block can only be read from
+    */
+    Serializer(uInt8* buffer, uInt32 size, bool readonly = false);
+
     /**
       Destructor
     */
@@ -74,12 +91,18 @@ class Serializer
     */
     void reset(void);
 
+    /**
+      Answers the number of bytes read/written since the last reset.
+      Only valid for memory block based devices.
+    */
+    uInt32 size(void) const { return myPosition; }
+
     /**
       Reads a byte value (unsigned 8-bit) from the current input stream.
 
       @result The byte value which has been read from the stream.
     */
-    uInt8 getByte(void);
+    uInt8 getByte(void) { uInt8 buf; readData(&buf, 1); return buf; }
 
     /**
       Reads a byte array (unsigned 8-bit) from the current input stream.
@@ -95,7 +118,12 @@ class Serializer
 
       @result The short value which has been read from the stream.
     */
-    uInt16 getShort(void);
+    uInt16 getShort(void)
+    {
+      uInt16 val = 0;
+      readData(&val, sizeof(uInt16));
+      return val;
+    }
 
     /**
       Reads a short array (unsigned 16-bit) from the current input stream.
@@ -110,7 +138,12 @@ class Serializer
 
       @result The int value which has been read from the stream.
     */
-    uInt32 getInt(void);
+    uInt32 getInt(void)
+    {
+      uInt32 val = 0;
+      readData(&val, sizeof(uInt32));
+      return val;
+    }
 
     /**
       Reads an integer array (unsigned 32-bit) from the current input stream.
@@ -132,14 +165,14 @@ class Serializer
 
       @result The boolean value which has been read from the stream.
     */
-    bool getBool(void);
+    bool getBool(void) { return getByte() == TruePattern; }
 
     /**
       Writes an byte value (unsigned 8-bit) to the current output stream.
 
       @param value The byte value to write to the output stream.
     */
-    void putByte(uInt8 value);
+    void putByte(uInt8 value) { writeData(&value, 1); }
 
     /**
       Writes a byte array (unsigned 8-bit) to the current output stream.
@@ -154,7 +187,7 @@ class Serializer
 
       @param value The short value to write to the output stream.
     */
-    void putShort(uInt16 value);
+    void putShort(uInt16 value) { writeData(&value, sizeof(uInt16)); }
 
     /**
       Writes a short array (unsigned 16-bit) to the current output stream.
@@ -169,7 +202,7 @@ class Serializer
 
       @param value The int value to write to the output stream.
     */
-    void putInt(uInt32 value);
+    void putInt(uInt32 value) { writeData(&value, sizeof(uInt32)); }
 
     /**
       Writes an integer array (unsigned 32-bit) to the current output stream.
@@ -191,7 +224,50 @@ class Serializer
 
       @param b The boolean value to write to the output stream.
     */
-    void putBool(bool b);
+    void putBool(bool b) { putByte(b ? TruePattern : FalsePattern); }
+
+    /**
+      Writes a device name tag to the current output stream.  Tags are
+      not written in compact mode (see setCompact()).
+
+      @param name The device name to write to the output stream.
+    */
+    void putTag(const string& name);
+
+    /**
+      Reads a device name tag from the current input stream, and answers
+      whether it matches the given name.  In compact mode nothing is read,
+      and the tag always matches.
+
+      @param name The device name expected in the input stream.
+      @result Whether the tag read matches the given name.
+    */
+    bool getTag(const string& name);
+
+    /**
+      Enables or disables compact mode.  Devices are always saved in the
+      same order, so the name tags which precede each device's state are
+      only a sanity check, and can be omitted.
+
+      @param compact Whether device name tags should be omitted
+    */
+    void setCompact(bool compact) { myCompact = compact; }
+
+    /**
+      Answers whether compact mode is enabled, which is always the case for
+      the current state format; states in the original format (as written
+      by older versions) are read with it disabled.
+
+      @result Whether device name tags are omitted
+    */
+    bool isCompact() const { return myCompact; }
+
+    /**
+      Answers the memory block used by this device (NULL if it's stream
+      based or only counts bytes), and its size.
+    */
+    uInt8* buffer(void) const { return myBuffer; }
+    uInt32 bufferSize(void) const { return myBufferSize; }
 
     std::string get()
     {
@@ -205,11 +281,51 @@ class Serializer
         s->str(data);
     }
 
+  private:
+    // Read/write raw data from/to the stream or memory block
+    // The common case of a memory block with enough room left is
+    // handled inline, since states are mostly made up of single values
+    void readData(void* data, uInt32 size)
+    {
+      if(myStream == NULL && myBuffer != NULL && !myOverflow &&
+         size <= myBufferSize - myPosition)
+      {
+        memcpy(data, myBuffer + myPosition, size);
+        myPosition += size;
+      }
+      else
+        readDataSlow(data, size);
+    }
+    void writeData(const void* data, uInt32 size)
+    {
+      if(myStream == NULL && myBuffer != NULL && !myOverflow && !myReadOnly &&
+         size <= myBufferSize - myPosition)
+      {
+        memcpy(myBuffer + myPosition, data, size);
+        myPosition += size;
+      }
+      else
+        writeDataSlow(data, size);
+    }
+    void readDataSlow(void* data, uInt32 size);
+    void writeDataSlow(const void* data, uInt32 size);
+
   private:
     // The stream to send the serialized data to.
     iostream* myStream;
     bool myUseFilestream;
 
+    // The memory block to send the serialized data to, when not
+    // using a stream
+    uInt8* myBuffer;
+    uInt32 myBufferSize;
+    uInt32 myPosition;
+    bool myReadOnly;
+    bool myOverflow;
+
+    // Whether device name tags are omitted
+    bool myCompact;
+
     enum {
       TruePattern  = 0xfe,
       FalsePattern = 0x01
@@ -33,35 +33,46 @@ Settings::Settings(OSystem* osystem)
   // Add this settings object to the OSystem
   myOSystem->attach(this);
 
+  // The known settings come first, in order of their identifiers
+  myInternalSettings.reserve(NumKeys);
+  for(int i = 0; i < NumKeys; ++i)
+  {
+    Setting setting;
+    setting.key = ourKeyNames[i];
+    myInternalSettings.push_back(setting);
+  }
+
   // Framebuffer-related options
-  setInternal("center", "false");
-  setInternal("grabmouse", "true");
-  setInternal("palette", "standard");
-  setInternal("colorloss", "true");
-  setInternal("timing", "sleep");
+  setValue(Center, "false");
+  setValue(GrabMouse, "true");
+  setValue(Palette, "standard");
+  setValue(ColorLoss, "true");
+  setValue(Timing, "sleep");
 
   // Sound options
-  setInternal("sound", "true");
-  setInternal("freq", "31400");
-  setInternal("volume", "100");
+  setValue(Sound, "true");
+  setValue(Freq, "31400");
+  setValue(Volume, "100");
 
   // Input event options
-  setInternal("joydeadzone", "13");
-  setInternal("joyallow4", "false");
-  setInternal("usemouse", "analog");
-  setInternal("dsense", "5");
-  setInternal("msense", "7");
-  setInternal("saport", "lr");
+  setValue(JoyDeadzone, "13");
+  setValue(JoyAllow4, "false");
+  setValue(UseMouse, "analog");
+  setValue(DSense, "5");
+  setValue(MSense, "7");
+  setValue(SAPort, "lr");
 
   // Misc options
-  setInternal("tiadriven", "false");
-  setInternal("cpurandom", "true");
-  setInternal("ramrandom", "true");
-  setInternal("avoxport", "");
-  setInternal("fastscbios", "false");
+  setValue(TIADriven, "false");
+  setValue(CPURandom, "true");
+  setValue(RAMRandom, "true");
+  setValue(AVoxPort, "");
+  setValue(FastSCBios, "false");
+  setValue(RomInfo, "false");
+  setValue(RomLoadCount, "0");
 
   // Thumb ARM emulation options
-  setInternal("thumb.trapfatal", "true");
+  setValue(ThumbTrapFatal, "true");
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -86,7 +97,8 @@ const Variant& Settings::value(const string& key) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Settings::setValue(const string& key, const Variant& value)
 {
-  if(int idx = getInternalPos(key) != -1)
+  int idx = getInternalPos(key);
+  if(idx != -1)
     setInternal(key, value, idx);
   else
     setExternal(key, value);
@@ -95,7 +107,22 @@ void Settings::setValue(const string& key, const Variant& value)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Settings::getInternalPos(const string& key) const
 {
-  for(unsigned int i = 0; i < myInternalSettings.size(); ++i)
+  // The known settings are found by binary search of their names
+  int low = 0, high = NumKeys - 1;
+  while(low <= high)
+  {
+    int i = (low + high) / 2;
+    int cmp = key.compare(ourKeyNames[i]);
+
+    if(cmp == 0)
+      return i;
+    else if(cmp < 0)
+      high = i - 1;
+    else
+      low = i + 1;
+  }
+
+  for(unsigned int i = NumKeys; i < myInternalSettings.size(); ++i)
     if(myInternalSettings[i].key == key)
       return i;
 
@@ -124,16 +151,7 @@ int Settings::setInternal(const string& key, const Variant& value,
     idx = pos;
   }
   else
-  {
-    for(unsigned int i = 0; i < myInternalSettings.size(); ++i)
-    {
-      if(myInternalSettings[i].key == key)
-      {
-        idx = i;
-        break;
-      }
-    }
-  }
+    idx = getInternalPos(key);
 
   if(idx != -1)
   {
@@ -208,3 +226,29 @@ Settings& Settings::operator = (const Settings&)
 {
   return *this;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const char* const Settings::ourKeyNames[NumKeys] = {
+  "avoxport",
+  "center",
+  "colorloss",
+  "cpurandom",
+  "dsense",
+  "fastscbios",
+  "freq",
+  "grabmouse",
+  "joyallow4",
+  "joydeadzone",
+  "msense",
+  "palette",
+  "ramrandom",
+  "rominfo",
+  "romloadcount",
+  "saport",
+  "sound",
+  "thumb.trapfatal",
+  "tiadriven",
+  "timing",
+  "usemouse",
+  "volume"
+};
@@ -36,6 +36,40 @@ class Settings
 {
   friend class OSystem;
 
+  public:
+    /**
+      The settings known to Stella, which can be accessed by these
+      identifiers as well as by name.  Accessing a setting by identifier
+      indexes it directly, without searching for or building a key string.
+      These are in order of their names (as given), since the names are
+      binary-searched.
+    */
+    enum Key {
+      AVoxPort,        // "avoxport"
+      Center,          // "center"
+      ColorLoss,       // "colorloss"
+      CPURandom,       // "cpurandom"
+      DSense,          // "dsense"
+      FastSCBios,      // "fastscbios"
+      Freq,            // "freq"
+      GrabMouse,       // "grabmouse"
+      JoyAllow4,       // "joyallow4"
+      JoyDeadzone,     // "joydeadzone"
+      MSense,          // "msense"
+      Palette,         // "palette"
+      RAMRandom,       // "ramrandom"
+      RomInfo,         // "rominfo"
+      RomLoadCount,    // "romloadcount"
+      SAPort,          // "saport"
+      Sound,           // "sound"
+      ThumbTrapFatal,  // "thumb.trapfatal"
+      TIADriven,       // "tiadriven"
+      Timing,          // "timing"
+      UseMouse,        // "usemouse"
+      Volume,          // "volume"
+      NumKeys
+    };
+
   public:
     /**
       Create a new settings abstract class
@@ -75,6 +109,17 @@ class Settings
     bool getBool(const string& key) const   { return value(key).toBool();  }
     const string& getString(const string& key) const { return value(key).toString(); }
 
+    /**
+      The same methods, for a setting known by its identifier.
+    */
+    const Variant& value(Key key) const { return myInternalSettings[key].value; }
+    void setValue(Key key, const Variant& value) { myInternalSettings[key].value = value; }
+
+    int getInt(Key key) const     { return value(key).toInt();   }
+    float getFloat(Key key) const { return value(key).toFloat(); }
+    bool getBool(Key key) const   { return value(key).toBool();  }
+    const string& getString(Key key) const { return value(key).toString(); }
+
   private:
     // Copy constructor isn't supported by this class so make it private
     Settings(const Settings&);
@@ -105,9 +150,13 @@ class Settings
     int setExternal(const string& key, const Variant& value,
                     int pos = -1, bool useAsInitial = false);
 
+    // The names of the known settings, indexed by Key
+    static const char* const ourKeyNames[NumKeys];
+
   private:
     // Holds key,value pairs that are necessary for Stella to
     // function and must be saved on each program exit.
+    // The first NumKeys entries are the known settings, indexed by Key.
     SettingsArray myInternalSettings;
 
     // Holds auxiliary key,value pairs that shouldn't be saved on
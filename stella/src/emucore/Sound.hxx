@@ -57,6 +57,8 @@ class Sound : public Serializable
     /**
       The system cycle counter is being adjusting by the specified amount.  Any
       members using the system cycle counter should be adjusted as needed.
+      Register writes which haven't been processed yet are applied
+      immediately, since they belong to a fragment which was never created.
 
       @param amount The amount the cycle counter is being adjusted by
     */
@@ -124,6 +126,10 @@ class Sound : public Serializable
       The stream is 16-bits (even though the callback is 8-bits), since
       the TIASnd class always generates signed 16-bit stereo samples.
 
+      The fragment starts with the current frame, and each register write
+      takes effect at the first sample following the cycle at which it
+      occurred.
+
       @param stream  Pointer to the start of the fragment
       @param length  Length of the fragment
     */
@@ -161,7 +167,7 @@ class Sound : public Serializable
     {
       uInt16 addr;
       uInt8 value;
-      double delta;
+      Int32 cycle;
     };
 
     /**
@@ -193,11 +199,6 @@ class Sound : public Serializable
         */
         void dequeue();
 
-        /**
-          Return the duration of all the items in the queue.
-        */
-        double duration();
-
         /**
           Enqueue the specified object.
         */
@@ -229,6 +230,14 @@ class Sound : public Serializable
     };
 
   private:
+    enum {
+      // Sample positions are kept exactly, in ticks of 1/94200 of a
+      // system cycle (1/3579575 of a sample), since the 6507 runs at
+      // 3579575/3 Hz and samples are generated at 31400 Hz
+      kTicksPerCycle  = 31400 * 3,
+      kTicksPerSample = 3579575
+    };
+
     // TIASound emulation object
     TIASound myTIASound;
 
@@ -238,9 +247,6 @@ class Sound : public Serializable
     // Indicates if the sound device was successfully initialized
     bool myIsInitializedFlag;
 
-    // Indicates the cycle when a sound register was last set
-    Int32 myLastRegisterSetCycle;
-
     // Indicates the number of channels (mono or stereo)
     uInt32 myNumChannels;
 
@@ -18,6 +18,7 @@
 //============================================================================
 
 #include <sstream>
+#include <cstring>
 
 #include "OSystem.hxx"
 #include "Settings.hxx"
@@ -26,6 +27,7 @@
 #include "Control.hxx"
 #include "Switches.hxx"
 #include "System.hxx"
+#include "TIA.hxx"
 #include "Serializable.hxx"
 
 #include "StateManager.hxx"
@@ -35,7 +37,8 @@
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StateManager::StateManager(OSystem* osystem)
-  : myOSystem(osystem)
+  : myOSystem(osystem),
+    myRewindManager(*this)
 {
   reset();
 }
@@ -48,6 +51,50 @@ StateManager::~StateManager()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::update()
 {
+  if(myRewindManager.enabled())
+    myRewindManager.addState(myOSystem->console().tia().frameCount());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Standard (zlib compatible) CRC32, processing four bytes per step
+static uInt32 crc32(const uInt8* data, uInt32 length)
+{
+  static uInt32 table[4][256];
+  static bool tableInitialized = false;
+
+  if(!tableInitialized)
+  {
+    for(uInt32 i = 0; i < 256; ++i)
+    {
+      uInt32 c = i;
+      for(int k = 0; k < 8; ++k)
+        c = (c & 1) ? (0xedb88320 ^ (c >> 1)) : (c >> 1);
+      table[0][i] = c;
+    }
+    for(uInt32 i = 0; i < 256; ++i)
+      for(int t = 1; t < 4; ++t)
+        table[t][i] = table[0][table[t-1][i] & 0xff] ^ (table[t-1][i] >> 8);
+    tableInitialized = true;
+  }
+
+  uInt32 crc = 0xffffffff;
+  for(; length >= 4; length -= 4, data += 4)
+  {
+    crc ^= data[0] | (data[1] << 8) | (data[2] << 16) | ((uInt32)data[3] << 24);
+    crc = table[3][crc & 0xff] ^ table[2][(crc >> 8) & 0xff] ^
+          table[1][(crc >> 16) & 0xff] ^ table[0][crc >> 24];
+  }
+  for(; length > 0; --length)
+    crc = table[0][(crc ^ *data++) & 0xff] ^ (crc >> 8);
+
+  return crc ^ 0xffffffff;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 StateManager::cartTag() const
+{
+  const string& name = myOSystem->console().cartridge().name();
+  return crc32((const uInt8*)name.data(), name.length());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -58,34 +105,95 @@ bool StateManager::loadState(Serializer& in)
     // Make sure the file can be opened for reading
     if(in.isValid())
     {
-      // First test if we have a valid header and cart type
-      // If so, do a complete state load using the Console
-      return in.getString() == STATE_HEADER &&
-             in.getString() == myOSystem->console().cartridge().name() &&
-             myOSystem->console().load(in);
+      uInt32 start = in.size();
+
+      // Older states start with the length of STATE_HEADER instead
+      if(in.getInt() != kStateMagic)
+      {
+        in.reset();
+        return loadLegacyState(in);
+      }
+
+      uInt16 version = in.getShort();
+      uInt16 flags   = in.getShort();
+      uInt32 tag     = in.getInt();
+      uInt32 length  = in.getInt();
+      uInt32 crc     = in.getInt();
+
+      if(version != kStateVersion || tag != cartTag() || !in.isValid())
+        return false;
+
+      // Verify the checksum before anything is modified
+      if(flags & kStateHasCRC)
+      {
+        uInt32 offset = start + kStateHeaderLen;
+        if(in.buffer() == NULL || length > in.bufferSize() - offset ||
+           crc32(in.buffer() + offset, length) != crc)
+          return false;
+      }
+
+      in.setCompact(true);
+      bool result = myOSystem->console().load(in);
+      in.setCompact(false);
+
+      return result;
     }
   }
   return false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool StateManager::saveState(Serializer& out)
+bool StateManager::loadLegacyState(Serializer& in)
+{
+  // First test if we have a valid header and cart type
+  // If so, do a complete state load using the Console
+  return in.getString() == STATE_HEADER &&
+         in.getString() == myOSystem->console().cartridge().name() &&
+         myOSystem->console().load(in);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::saveState(Serializer& out, bool checksum)
 {
     if(&myOSystem->console())
     {
       // Make sure the file can be opened for writing
       if(out.isValid())
       {
-        // Add header so that if the state format changes in the future,
-        // we'll know right away, without having to parse the rest of the file
-        out.putString(STATE_HEADER);
+        uInt32 start = out.size();
 
-        // Sanity check; prepend the cart type/name
-        out.putString(myOSystem->console().cartridge().name());
+        // A checksum can only be stored when the state is in memory,
+        // since the header must be updated once the state is written
+        if(out.buffer() == NULL)
+          checksum = false;
+
+        // Add header so that if the state format changes in the future,
+        // we'll know right away, without having to parse the rest of the
+        // state; the cart type is identified by a numeric tag
+        out.putInt(kStateMagic);
+        out.putShort(kStateVersion);
+        out.putShort(checksum ? kStateHasCRC : 0);
+        out.putInt(cartTag());
+        out.putInt(0);  // length, filled in below
+        out.putInt(0);  // CRC, filled in below
 
         // Do a complete state save using the Console
-        if(myOSystem->console().save(out))
-          return true;
+        out.setCompact(true);
+        bool result = myOSystem->console().save(out);
+        out.setCompact(false);
+
+        if(result && checksum && out.isValid())
+        {
+          uInt8* header  = out.buffer() + start;
+          uInt32 length  = out.size() - start - kStateHeaderLen;
+          uInt32 crc     = crc32(header + kStateHeaderLen, length);
+
+          // Stored in the same byte order as putInt()
+          memcpy(header + 12, &length, sizeof(uInt32));
+          memcpy(header + 16, &crc, sizeof(uInt32));
+        }
+
+        return result;
       }
     }
   return false;
@@ -94,10 +202,12 @@ bool StateManager::saveState(Serializer& out)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::reset()
 {
+  myRewindManager.clear();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StateManager::StateManager(const StateManager&)
+  : myRewindManager(*this)
 {
 }
 
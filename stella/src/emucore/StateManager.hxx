@@ -23,6 +23,7 @@
 class OSystem;
 
 #include "Serializer.hxx"
+#include "RewindManager.hxx"
 
 /**
   This class provides an interface to all things related to emulation state.
@@ -47,12 +48,22 @@ class StateManager
 
   public:
     /**
-      Updates the state of the system based on the currently active mode
+      Updates the state of the system based on the currently active mode.
+      This should be called once per frame, before it's emulated; when
+      rewinding is enabled, the current state is added to the rewind
+      history.
     */
     void update();
 
+    /**
+      The rewind history of the current system
+    */
+    RewindManager& rewindManager() { return myRewindManager; }
+
     /**
       Load a state into the current system from the given Serializer.
+      Both the compact format and the older string based format (as
+      written by previous versions) are accepted.
       No messages are printed to the screen.
 
       @param in  The Serializer object to use
@@ -62,14 +73,17 @@ class StateManager
     bool loadState(Serializer& in);
 
     /**
-      Save the current state from the system into the given Serializer.
+      Save the current state from the system into the given Serializer,
+      using the compact format.  If the Serializer is memory based, the
+      state can be protected by a CRC32, which is verified on load.
       No messages are printed to the screen.
 
-      @param out  The Serializer object to use
+      @param out       The Serializer object to use
+      @param checksum  Whether to store a CRC32 of the state
 
       @return  False on any save errors, else true
     */
-    bool saveState(Serializer& out);
+    bool saveState(Serializer& out, bool checksum = true);
 
     /**
       Resets manager to defaults
@@ -83,13 +97,31 @@ class StateManager
     // Assignment operator isn't supported by this class so make it private
     StateManager& operator = (const StateManager&);
 
+    // Load a state in the format used before the compact format,
+    // identified by STATE_HEADER and the cart name as strings
+    bool loadLegacyState(Serializer& in);
+
+    // Answers a numeric tag identifying the current cart type
+    uInt32 cartTag() const;
+
   private:
     enum {
       kVersion = 001
     };
 
+    // Compact state header fields
+    enum {
+      kStateMagic     = 0x1a363253,  // "S26\x1a"
+      kStateVersion   = 1,
+      kStateHasCRC    = 0x0001,
+      kStateHeaderLen = 20
+    };
+
     // The parent OSystem object
     OSystem* myOSystem;
+
+    // History of recent states, used for rewinding
+    RewindManager myRewindManager;
 };
 
 #endif
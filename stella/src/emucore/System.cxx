@@ -34,6 +34,8 @@ System::System(uInt16 n, uInt16 m)
     myTIA(0),
     myCycles(0),
     myDataBusState(0),
+    myFetchPage(myNumberOfPages),
+    myFetchBase(0),
     myDataBusLocked(false),
     mySystemInAutodetect(false)
 {
@@ -154,6 +156,9 @@ void System::resetCycles()
 void System::setPageAccess(uInt16 page, const PageAccess& access)
 {
   myPageAccessTable[page] = access;
+
+  // The page code is fetched from may have just been remapped
+  myFetchPage = myNumberOfPages;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -211,6 +216,22 @@ uInt8 System::peek(uInt16 addr, uInt8 flags)
   return result;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 System::fetchFromNewPage(uInt16 addr)
+{
+  uInt16 page = (addr & myAddressMask) >> myPageShift;
+  const PageAccess& access = myPageAccessTable[page];
+
+  // Only pages without side effects on read can be fetched from directly
+  if(access.directPeekBase)
+  {
+    myFetchPage = page;
+    myFetchBase = access.directPeekBase;
+  }
+
+  return peek(addr);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void System::poke(uInt16 addr, uInt8 value)
 {
@@ -248,7 +269,7 @@ void System::unlockDataBus()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool System::save(Serializer& out) const
 {
-   out.putString(name());
+   out.putTag(name());
    out.putInt(myCycles);
    out.putByte(myDataBusState);
 
@@ -266,7 +287,7 @@ bool System::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool System::load(Serializer& in)
 {
-   if(in.getString() != name())
+   if(!in.getTag(name()))
       return false;
 
    myCycles = in.getInt();
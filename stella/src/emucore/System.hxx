@@ -242,6 +242,25 @@ class System : public Serializable
     */
     uInt8 peek(uInt16 address, uInt8 flags = 0);
 
+    /**
+      Get the byte at the specified address as part of an instruction
+      fetch.  This behaves exactly like peek(), but remembers the page
+      code was last fetched from.  As long as that page is read directly
+      from memory (and isn't remapped), further fetches from it bypass
+      the page access table and the device.
+
+      @param address  The address from which the code should be loaded
+
+      @return The byte at the specified address
+    */
+    uInt8 fetch(uInt16 address)
+    {
+      if(((address & myAddressMask) >> myPageShift) == myFetchPage)
+        return myDataBusState = myFetchBase[address & myPageMask];
+
+      return fetchFromNewPage(address);
+    }
+
     /**
       Change the byte at the specified address to the given value.
       No masking of the address occurs before it's sent to the device
@@ -406,6 +425,13 @@ class System : public Serializable
     */
     string name() const { return "System"; }
 
+  private:
+    /**
+      Fetch the byte at the specified address, which is outside the page
+      remembered by fetch(), and remember its page if possible.
+    */
+    uInt8 fetchFromNewPage(uInt16 address);
+
   private:
     // Mask to apply to an address before accessing memory
     const uInt16 myAddressMask;
@@ -453,6 +479,11 @@ class System : public Serializable
     // The current state of the Data Bus
     uInt8 myDataBusState;
 
+    // Page code was last fetched from (myNumberOfPages if none), and the
+    // memory it's directly read from
+    uInt32 myFetchPage;
+    const uInt8* myFetchBase;
+
     // Whether or not peek() updates the data bus state. This
     // is true during normal emulation, and false when the
     // debugger is active.
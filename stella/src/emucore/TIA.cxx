@@ -37,6 +37,35 @@
 
 #define CLAMP_POS(reg) if(reg < 0) { reg += 160; }  reg %= 160;
 
+// Replicate a byte into all eight bytes of a 64-bit word
+#define SPREAD8(b) (uInt64(b) * 0x0101010101010101ULL)
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// OR 'bit' into each entry of 'objects' in [start, end) for which the
+// corresponding entry of 'mask' has any bits in common with 'graphics'.
+// Eight pixels are handled at a time, with each byte of a 64-bit word
+// reduced to 0 or 1 before being scaled by 'bit'.
+static inline void spanObject(uInt8* objects, const uInt8* mask,
+                              uInt32 start, uInt32 end,
+                              uInt8 graphics, uInt8 bit)
+{
+  const uInt64 g = SPREAD8(graphics);
+  uInt32 hpos = start;
+  for(; hpos + 8 <= end; hpos += 8)
+  {
+    uInt64 m, o;
+    memcpy(&m, mask + hpos, 8);
+    memcpy(&o, objects + hpos, 8);
+    m &= g;
+    m |= m >> 1;  m |= m >> 2;  m |= m >> 4;
+    o |= (m & SPREAD8(1)) * bit;
+    memcpy(objects + hpos, &o, 8);
+  }
+  for(; hpos < end; ++hpos)
+    if(mask[hpos] & graphics)
+      objects[hpos] |= bit;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TIA::TIA(Console& console, Sound& sound, Settings& settings)
   : myConsole(console),
@@ -46,11 +75,15 @@ TIA::TIA(Console& console, Sound& sound, Settings& settings)
     myFrameHeight(210),
     myMaximumNumberOfScanlines(262),
     myStartScanline(0),
+    myPFPixelsPF(0),
+    myPFPixelsMask(0),
     myColorLossEnabled(false),
     myPartialFrameFlag(false),
     myAutoFrameEnabled(false),
+    myRenderingEnabled(true),
     myFrameCounter(0),
     myPALFrameCounter(0),
+    myFrameUpdateCount(0),
     myBitsEnabled(true),
     myCollisionsEnabled(true)
    
@@ -63,6 +96,7 @@ TIA::TIA(Console& console, Sound& sound, Settings& settings)
   enableBits(true);
 
   // Turn off debug colours (this also sets up the PriorityEncoder)
+  myPriorityEncoderMode = -1;
   toggleFixedColors(0);
 
   // Compute all of the mask tables
@@ -72,7 +106,7 @@ TIA::TIA(Console& console, Sound& sound, Settings& settings)
   myAUDV0 = myAUDV1 = myAUDF0 = myAUDF1 = myAUDC0 = myAUDC1 = 0;
 
   // Should undriven pins be randomly pulled high or low?
-  myTIAPinsDriven = mySettings.getBool("tiadriven");
+  myTIAPinsDriven = mySettings.getBool(Settings::TIADriven);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -143,6 +177,7 @@ void TIA::reset()
   myM1Mask = &TIATables::MxMask[0][0][0];
   myBLMask = &TIATables::BLMask[0][0];
   myPFMask = TIATables::PFMask[0];
+  myPFPixelsMask = 0;
 
   // Recalculate the size of the display
   toggleFixedColors(0);
@@ -189,7 +224,7 @@ void TIA::frameReset()
     myFixedColor[PFColor]     = 0xd8;
     myFixedColor[BKColor]     = 0x1c;
     myFixedColor[HBLANKColor] = 0x0e;
-    myColorLossEnabled = mySettings.getBool("colorloss");
+    myColorLossEnabled = mySettings.getBool(Settings::ColorLoss);
     myMaximumNumberOfScanlines = 342;
   }
 
@@ -264,7 +299,7 @@ bool TIA::save(Serializer& out) const
 {
   const string& device = name();
 
-    out.putString(device);
+    out.putTag(device);
 
     out.putInt(myClockWhenFrameStarted);
     out.putInt(myClockStartDisplay);
@@ -359,7 +394,7 @@ bool TIA::load(Serializer& in)
 {
   const string& device = name();
 
-    if(in.getString() != device)
+    if(!in.getTag(device))
       return false;
 
     myClockWhenFrameStarted = (Int32) in.getInt();
@@ -472,6 +507,12 @@ void TIA::update()
 
   // TODO: have code here that handles errors....
 
+  // WSYNC, audio and redundant writes leave the frame to be drawn by a
+  // later write; a frame ended by VSYNC or the scanline limit was drawn
+  // by that write, otherwise draw up to the current cycle here
+  if(myPartialFrameFlag)
+    updateFrame(mySystem->cycles() * 3);
+
   endFrame();
 }
 
@@ -731,6 +772,12 @@ bool TIA::toggleFixedColors(uInt8 mode)
   if(on)  myColorPtr = myFixedColor;
   else    myColorPtr = myColor;
 
+  // The PriorityEncoder only depends on the mode, so there's no need to
+  // set it up again when it hasn't changed (as when a state is loaded)
+  if(myPriorityEncoderMode == (Int32)on)
+    return on;
+  myPriorityEncoderMode = on;
+
   // Set PriorityEncoder
   // This needs to be done here, since toggling debug colours also changes
   // how colours are interpreted in PF 'score' mode
@@ -794,7 +841,7 @@ bool TIA::driveUnusedPinsRandom(uInt8 mode)
   if(mode == 0 || mode == 1)
   {
     myTIAPinsDriven = bool(mode);
-    mySettings.setValue("tiadriven", myTIAPinsDriven);
+    mySettings.setValue(Settings::TIADriven, myTIAPinsDriven);
   }
   return myTIAPinsDriven;
 }
@@ -808,6 +855,8 @@ void TIA::updateFrame(Int32 clock)
      (myClockAtLastUpdate >= clock))
     return;
 
+  ++myFrameUpdateCount;
+
   // Truncate the number of cycles to update to the stop display point
   if(clock > myClockStopDisplay)
     clock = myClockStopDisplay;
@@ -914,7 +963,8 @@ void TIA::updateFrame(Int32 clock)
       // See if we're in the vertical blank region
       if(myVBLANK & 0x02)
       {
-        memset(myFramePointer, 0, clocksToUpdate);
+        if(myRenderingEnabled)
+          memset(myFramePointer, 0, clocksToUpdate);
       }
       // Handle all other possible combinations
       else
@@ -983,30 +1033,7 @@ void TIA::updateFrame(Int32 clock)
 
         uInt8 enabledObjects = myEnabledObjects & myDisabledObjects;
         uInt32 hpos = clocksFromStartOfScanLine - HBLANK;
-        for(; myFramePointer < ending; ++myFramePointer, ++hpos)
-        {
-          uInt8 enabled = ((enabledObjects & PFBit) &&
-                           (myPF & myPFMask[hpos])) ? PFBit : 0;
-
-          if((enabledObjects & BLBit) && myBLMask[hpos])
-            enabled |= BLBit;
-
-          if((enabledObjects & P1Bit) && (myCurrentGRP1 & myP1Mask[hpos]))
-            enabled |= P1Bit;
-
-          if((enabledObjects & M1Bit) && myM1Mask[hpos])
-            enabled |= M1Bit;
-
-          if((enabledObjects & P0Bit) && (myCurrentGRP0 & myP0Mask[hpos]))
-            enabled |= P0Bit;
-
-          if((enabledObjects & M0Bit) && myM0Mask[hpos])
-            enabled |= M0Bit;
-
-          myCollision |= TIATables::CollisionMask[enabled];
-          *myFramePointer = myColorPtr[myPriorityEncoder[hpos < 80 ? 0 : 1]
-              [enabled | myPlayfieldPriorityAndScore]];
-        }
+        renderSpan(myFramePointer, hpos, hpos + clocksToUpdate, enabledObjects);
       }
       myFramePointer = ending;
     }
@@ -1016,7 +1043,8 @@ void TIA::updateFrame(Int32 clock)
         (clocksFromStartOfScanLine < (HBLANK + 8)))
     {
       Int32 blanks = (HBLANK + 8) - clocksFromStartOfScanLine;
-      memset(oldFramePointer, myColorPtr[HBLANKColor], blanks);
+      if(myRenderingEnabled)
+        memset(oldFramePointer, myColorPtr[HBLANKColor], blanks);
 
       if((clocksToUpdate + clocksFromStartOfScanLine) >= (HBLANK + 8))
         myHMOVEBlankEnabled = false;
@@ -1036,6 +1064,121 @@ void TIA::updateFrame(Int32 clock)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void TIA::renderSpan(uInt8* fb, uInt32 start, uInt32 end,
+                            uInt8 enabledObjects)
+{
+  // Object bits for each pixel of this span, indexed by hpos
+  uInt8 objects[160];
+  uInt32 hpos;
+
+  // Without any pixels to draw only the collisions matter, and these
+  // need at least two objects which can produce pixels on this span
+  if(!myRenderingEnabled)
+  {
+    uInt8 visible = enabledObjects;
+    if(!myPF)          visible &= ~PFBit;
+    if(!myCurrentGRP0) visible &= ~P0Bit;
+    if(!myCurrentGRP1) visible &= ~P1Bit;
+    if(!(visible & (visible - 1)))
+      return;
+  }
+
+  // Build the object bitmap one graphical object at a time; objects which
+  // can't produce any pixels on this span are skipped completely
+  if(enabledObjects & PFBit)
+  {
+    // The playfield only changes with PF0-2 and CTRLPF reflection, which
+    // are rewritten a few times per scanline at most, so it's expanded
+    // into pixels (four per playfield bit) only when either changes
+    if(myPF != myPFPixelsPF || myPFMask != myPFPixelsMask)
+    {
+      for(hpos = 0; hpos < 160; hpos += 4)
+      {
+        uInt32 pixels = (myPF & myPFMask[hpos]) ? PFBit * 0x01010101 : 0;
+        memcpy(myPFPixels + hpos, &pixels, 4);
+      }
+      myPFPixelsPF = myPF;
+      myPFPixelsMask = myPFMask;
+    }
+    memcpy(objects + start, myPFPixels + start, end - start);
+  }
+  else
+    memset(objects + start, 0, end - start);
+
+  if(enabledObjects & BLBit)
+    spanObject(objects, myBLMask, start, end, 0xFF, BLBit);
+
+  if((enabledObjects & P1Bit) && myCurrentGRP1)
+    spanObject(objects, myP1Mask, start, end, myCurrentGRP1, P1Bit);
+
+  if(enabledObjects & M1Bit)
+    spanObject(objects, myM1Mask, start, end, 0xFF, M1Bit);
+
+  if((enabledObjects & P0Bit) && myCurrentGRP0)
+    spanObject(objects, myP0Mask, start, end, myCurrentGRP0, P0Bit);
+
+  if(enabledObjects & M0Bit)
+    spanObject(objects, myM0Mask, start, end, 0xFF, M0Bit);
+
+  if(!myRenderingEnabled)
+  {
+    uInt16 collision = 0;
+    for(hpos = start; hpos < end; ++hpos)
+      collision |= TIATables::CollisionMask[objects[hpos]];
+    myCollision |= collision;
+    return;
+  }
+
+  // Now emit the pixels one half of the scanline at a time, since the
+  // priority encoder differs for each half (score mode).  A half which
+  // shows a single object combination throughout (background, solid
+  // playfield, etc) is filled with one memset and one collision update.
+  const uInt8* colors = myColorPtr;
+  uInt8 score = myPlayfieldPriorityAndScore;
+  hpos = start;
+  while(hpos < end)
+  {
+    uInt32 half = hpos < 80 ? 0 : 1;
+    uInt32 limit = (half == 0 && end > 80) ? 80 : end;
+    const uInt8* encoder = myPriorityEncoder[half];
+    uInt8 enabled = objects[hpos];
+
+    // Find how far the first object combination extends, eight pixels
+    // at a time
+    uInt32 run = hpos + 1;
+    uInt64 pattern = SPREAD8(enabled), block;
+    while(run + 8 <= limit)
+    {
+      memcpy(&block, objects + run, 8);
+      if(block != pattern)
+        break;
+      run += 8;
+    }
+    while(run < limit && objects[run] == enabled)
+      ++run;
+
+    if(run == limit)
+    {
+      myCollision |= TIATables::CollisionMask[enabled];
+      memset(fb, colors[encoder[enabled | score]], limit - hpos);
+      fb += limit - hpos;
+    }
+    else
+    {
+      uInt16 collision = 0;
+      for(; hpos < limit; ++hpos, ++fb)
+      {
+        enabled = objects[hpos];
+        collision |= TIATables::CollisionMask[enabled];
+        *fb = colors[encoder[enabled | score]];
+      }
+      myCollision |= collision;
+    }
+    hpos = limit;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void TIA::waitHorizontalSync()
 {
@@ -1250,16 +1393,36 @@ bool TIA::poke(uInt16 addr, uInt8 value)
     delay = d[(x / 3) & 3];
   }
 
-  // Update frame to current CPU cycle before we make any changes!
-  updateFrame(clock + delay);
-
   // If a VSYNC hasn't been generated in time go ahead and end the frame
   if(((clock - myClockWhenFrameStarted) / 228) >= (Int32)myMaximumNumberOfScanlines)
   {
+    // This write may not update the frame below, so do it before ending
+    updateFrame(clock + delay);
     mySystem->m6502().stop();
     myPartialFrameFlag = false;
   }
 
+  // Kernels rewrite many registers every scanline whether they change or
+  // not; the frame only needs updating once something actually changes
+  if(pokeIsRedundant(addr, value))
+    return true;
+
+  // Update frame to current CPU cycle before we make any changes!
+  // Audio and WSYNC don't affect the picture, so the frame is left to
+  // be updated by the next write which does (or when the frame ends)
+  switch(addr)
+  {
+    case WSYNC:
+    case AUDC0: case AUDC1:
+    case AUDF0: case AUDF1:
+    case AUDV0: case AUDV1:
+      break;
+
+    default:
+      updateFrame(clock + delay);
+      break;
+  }
+
   switch(addr)
   {
     case VSYNC:    // Vertical sync set-clear
@@ -2022,6 +2185,64 @@ bool TIA::poke(uInt16 addr, uInt8 value)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIA::pokeIsRedundant(uInt16 addr, uInt8 value) const
+{
+  // Only registers whose handlers in poke() do nothing but store the
+  // value (and things derived solely from it) are considered here
+  switch(addr)
+  {
+    case COLUP0:
+    case COLUP1:
+    case COLUPF:
+    case COLUBK:
+    {
+      uInt8 color = value & 0xfe;
+      if(myColorLossEnabled && (myScanlineCountForLastFrame & 0x01))
+        color |= 0x01;
+
+      switch(addr)
+      {
+        case COLUP0:
+          return myColor[P0Color] == color && myColor[M0Color] == color;
+        case COLUP1:
+          return myColor[P1Color] == color && myColor[M1Color] == color;
+        case COLUPF:
+          return myColor[PFColor] == color && myColor[BLColor] == color;
+        default:
+          return myColor[BKColor] == color;
+      }
+    }
+
+    case PF0:
+      return ((myPF & 0x0000F) == ((value >> 4) & 0x0F));
+
+    case PF1:
+      return (((myPF >> 4) & 0xFF) == value);
+
+    case PF2:
+      return ((myPF >> 12) == value);
+
+    case REFP0:
+      return (bool(value & 0x08) == myREFP0);
+
+    case REFP1:
+      return (bool(value & 0x08) == myREFP1);
+
+    case ENAM0:
+      return (bool(value & 0x02) == myENAM0);
+
+    case ENAM1:
+      return (bool(value & 0x02) == myENAM1);
+
+    case ENABL:
+      return (bool(value & 0x02) == myENABL);
+
+    default:
+      return false;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // Note that the following methods to change the horizontal motion registers
 // are not completely accurate.  We should be taking care of the following
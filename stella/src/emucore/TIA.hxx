@@ -194,6 +194,16 @@ class TIA : public Device
     void enableColorLoss(bool mode)
       { myColorLossEnabled = myFramerate <= 55 ? mode : false; }
 
+    /**
+      Enables/disables generation of pixels.  While disabled, frames are
+      still emulated in full (including collisions, so games behave the
+      same), but nothing is drawn into the framebuffer.  This is useful
+      for frames which won't be shown.
+
+      @param mode  Whether to enable or disable generation of pixels
+    */
+    void enableRendering(bool mode) { myRenderingEnabled = mode; }
+
     /**
       Answers whether this TIA runs at NTSC or PAL scanrates,
       based on how many frames of out the total count are PAL frames.
@@ -201,6 +211,34 @@ class TIA : public Device
     bool isPAL()
       { return float(myPALFrameCounter) / myFrameCounter >= (25.0/60.0); }
 
+    /**
+      Answers whether isPAL() is certain to give its current answer no
+      matter what the given number of frames still to come look like.
+
+      @param frames  The number of frames which will still be generated
+    */
+    bool isPALSettled(uInt32 frames) const
+    {
+      uInt32 total = myFrameCounter + frames;
+      return float(myPALFrameCounter) / total >= (25.0/60.0) ||
+             float(myPALFrameCounter + frames) / total < (25.0/60.0);
+    }
+
+    /**
+      Answers the number of frames started since the TIA was reset.
+      The count is part of the saved state, so loading an earlier state
+      makes it go back as well.
+    */
+    uInt32 frameCount() const { return myFrameCounter; }
+
+    /**
+      Answers how many times the frame buffer has been brought up to date
+      with the CPU (for profiling how often register writes force it).
+
+      @return The number of frame buffer updates since creation
+    */
+    uInt32 frameUpdateCount() const { return myFrameUpdateCount; }
+
     uInt64 getMilliSeconds() const {
         uInt64 ntscFrames = myFrameCounter - myPALFrameCounter;
         return ntscFrames * (1000.0f/60.0f) + myPALFrameCounter * (1000.0f/50.f);
@@ -327,6 +365,14 @@ class TIA : public Device
     // Update the current frame buffer to the specified color clock
     void updateFrame(Int32 clock);
 
+    // Answer whether writing the value to the register is redundant, ie,
+    // it already holds the value and the write would change nothing
+    bool pokeIsRedundant(uInt16 addr, uInt8 value) const;
+
+    // Render the visible pixels [start, end) of the current scanline into
+    // the given frame buffer location, updating the collision latches
+    void renderSpan(uInt8* fb, uInt32 start, uInt32 end, uInt8 enabledObjects);
+
     // Waste cycles until the current scanline is finished
     void waitHorizontalSync();
 
@@ -432,6 +478,7 @@ class TIA : public Device
 
     uInt8 myPlayfieldPriorityAndScore;
     uInt8 myPriorityEncoder[2][256];
+    Int32 myPriorityEncoderMode;  // Mode PriorityEncoder is set up for
     uInt8 myColor[8];
     uInt8 myFixedColor[8];
     uInt8* myColorPtr;
@@ -533,6 +580,12 @@ class TIA : public Device
     const uInt8* myBLMask;
     const uInt32* myPFMask;
 
+    // Playfield pixels of a scanline (PFBit or 0 for each), expanded from
+    // the given playfield graphics and mask; see renderSpan()
+    uInt8 myPFPixels[160];
+    uInt32 myPFPixelsPF;
+    const uInt32* myPFPixelsMask;
+
     // Audio values; only used by TIADebug
     uInt8 myAUDV0, myAUDV1, myAUDC0, myAUDC1, myAUDF0, myAUDF1;
 
@@ -576,12 +629,18 @@ class TIA : public Device
     // Automatic framerate correction based on number of scanlines
     bool myAutoFrameEnabled;
 
+    // Indicates whether pixels are drawn into the framebuffer
+    bool myRenderingEnabled;
+
     // Number of total frames displayed by this TIA
     uInt32 myFrameCounter;
 
     // Number of PAL frames displayed by this TIA
     uInt32 myPALFrameCounter;
 
+    // Number of times the frame buffer was updated (see updateFrame())
+    uInt32 myFrameUpdateCount;
+
     // The framerate currently in use by the Console
     float myFramerate;
 
@@ -43,6 +43,22 @@ void TIASound::reset()
   polyInit(Bit5, 5, 5, 3);
   polyInit(Bit9, 9, 9, 5);
 
+  // Work out which P5 positions produce a clock tick in each mode; in
+  // POLY5 -> DIV3 mode, only the ticks where the P5 bit changes matter
+  for(int audc = 0; audc < 16; ++audc)
+  {
+    for(int p5 = 0; p5 < POLY5_SIZE; ++p5)
+    {
+      int prev_bit5 = Bit5[p5 > 0 ? p5 - 1 : POLY5_SIZE - 1];
+      if(audc == POLY5_DIV3)
+        myClockTick[audc][p5] = Bit5[p5] != prev_bit5;
+      else
+        myClockTick[audc][p5] = (audc & 0x02) == 0 ||
+                                ((audc & 0x01) == 0 && Div31[p5]) ||
+                                ((audc & 0x01) == 1 && Bit5[p5]);
+    }
+  }
+
   // Initialize instance variables
   for(int chan = 0; chan <= 1; ++chan)
   {
@@ -171,6 +187,226 @@ void TIASound::volume(uInt32 percent)
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASound::process(Int16* buffer, uInt32 samples)
+{
+  // Each sound clock produces exactly one sample at the native frequency,
+  // so the channels can be rendered independently, a block at a time
+  if(myOutputFrequency != 31400)
+  {
+    processResampled(buffer, samples);
+    return;
+  }
+
+  // Take external volume into account
+  Int16 audv0 = (myAUDV[0] * myVolumePercentage) / 100,
+        audv1 = (myAUDV[1] * myVolumePercentage) / 100;
+
+  // Channels are rendered separately and then interleaved; when neither
+  // changes during a block (ie, silence or low tones) it's a simple fill
+  Int16 level0[kBlockSize], level1[kBlockSize];
+  while(samples > 0)
+  {
+    uInt32 count = samples < kBlockSize ? samples : kBlockSize;
+    bool constant0 = processChannel(0, level0, count, audv0),
+         constant1 = processChannel(1, level1, count, audv1);
+
+    if(constant0 && constant1)
+      buffer = fill(buffer, count, myVolume[0], myVolume[1]);
+    else
+    {
+      if(constant0)
+        fillLevel(level0, count, myVolume[0]);
+      if(constant1)
+        fillLevel(level1, count, myVolume[1]);
+      buffer = interleave(buffer, count, level0, level1);
+    }
+    samples -= count;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline bool TIASound::processChannel(int chan, Int16* level, uInt32 samples,
+                                     Int16 audv)
+{
+  uInt8 div_n_cnt = myDivNCnt[chan];
+  Int16 v = myVolume[chan];
+
+  // The output only changes when the 'divide by n' counter runs out, so
+  // it's stored a run at a time, whenever it changes
+  uInt32 pos = 0, start = 0;
+  if(div_n_cnt > 0)
+  {
+    while(div_n_cnt <= samples - pos)
+    {
+      pos += div_n_cnt;
+      div_n_cnt = myDivNMax[chan];
+
+      Int16 next = clockChannel(chan, v, audv);
+      if(next != v)
+      {
+        fillLevel(level + start, pos - 1 - start, v);
+        start = pos - 1;
+        v = next;
+      }
+    }
+    div_n_cnt -= samples - pos;
+  }
+
+  // Save for next round
+  myDivNCnt[chan] = div_n_cnt;
+  myVolume[chan] = v;
+
+  if(start == 0)
+    return true;
+
+  fillLevel(level + start, samples - start, v);
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void TIASound::fillLevel(Int16* level, uInt32 samples, Int16 v)
+{
+  for(uInt32 i = 0; i < samples; ++i)
+    level[i] = v;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline Int16* TIASound::fill(Int16* buffer, uInt32 length, Int16 v0, Int16 v1)
+{
+  switch(myChannelMode)
+  {
+    case Hardware2Mono:  // mono sampling with 2 hardware channels
+    {
+      Int16 byte = v0 + v1;
+      for(uInt32 i = 0; i < length; ++i)
+      {
+        *(buffer++) = byte;
+        *(buffer++) = byte;
+      }
+      break;
+    }
+
+    case Hardware2Stereo:  // stereo sampling with 2 hardware channels
+      for(uInt32 i = 0; i < length; ++i)
+      {
+        *(buffer++) = v0;
+        *(buffer++) = v1;
+      }
+      break;
+
+    case Hardware1:  // mono/stereo sampling with only 1 hardware channel
+    {
+      Int16 byte = v0 + v1;
+      for(uInt32 i = 0; i < length; ++i)
+        *(buffer++) = byte;
+      break;
+    }
+  }
+
+  return buffer;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline Int16* TIASound::interleave(Int16* buffer, uInt32 length,
+                                  const Int16* level0, const Int16* level1)
+{
+  switch(myChannelMode)
+  {
+    case Hardware2Mono:  // mono sampling with 2 hardware channels
+    {
+      for(uInt32 i = 0; i < length; ++i)
+      {
+        Int16 byte = level0[i] + level1[i];
+        *(buffer++) = byte;
+        *(buffer++) = byte;
+      }
+      break;
+    }
+
+    case Hardware2Stereo:  // stereo sampling with 2 hardware channels
+      for(uInt32 i = 0; i < length; ++i)
+      {
+        *(buffer++) = level0[i];
+        *(buffer++) = level1[i];
+      }
+      break;
+
+    case Hardware1:  // mono/stereo sampling with only 1 hardware channel
+    {
+      for(uInt32 i = 0; i < length; ++i)
+        *(buffer++) = level0[i] + level1[i];
+      break;
+    }
+  }
+
+  return buffer;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline Int16 TIASound::clockChannel(int chan, Int16 v, Int16 audv)
+{
+  uInt8 audc = myAUDC[chan];
+
+  // The P5 counter has multiple uses, so we increment it here
+  uInt8 p5 = myP5[chan] + 1;
+  if(p5 == POLY5_SIZE)
+    p5 = 0;
+  myP5[chan] = p5;
+
+  // Check clock modifier for clock tick
+  if(!myClockTick[audc][p5])
+    return v;
+
+  if(audc & 0x04)       // Pure modified clock selected
+  {
+    if(audc == POLY5_DIV3) // POLY5 -> DIV3 mode
+    {
+      if(--myDiv3Cnt[chan] == 0)
+      {
+        myDiv3Cnt[chan] = 3;
+        v = v ? 0 : audv;
+      }
+    }
+    else
+    {
+      // If the output was set turn it off, else turn it on
+      v = v ? 0 : audv;
+    }
+  }
+  else if(audc & 0x08)  // Check for p5/p9
+  {
+    if(audc == POLY9)   // Check for poly9
+    {
+      // Increase the poly9 counter
+      myP9[chan]++;
+      if(myP9[chan] == POLY9_SIZE)
+        myP9[chan] = 0;
+
+      v = Bit9[myP9[chan]] ? audv : 0;
+    }
+    else if(audc & 0x02)
+    {
+      v = (v || audc & 0x01) ? 0 : audv;
+    }
+    else  // Must be poly5
+    {
+      v = Bit5[p5] ? audv : 0;
+    }
+  }
+  else  // Poly4 is the only remaining option
+  {
+    // Increase the poly4 counter
+    myP4[chan]++;
+    if(myP4[chan] == POLY4_SIZE)
+      myP4[chan] = 0;
+
+    v = Bit4[myP4[chan]] ? audv : 0;
+  }
+
+  return v;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::processResampled(Int16* buffer, uInt32 samples)
 {
   // Make temporary local copy
   uInt8 audc0 = myAUDC[0], audc1 = myAUDC[1];
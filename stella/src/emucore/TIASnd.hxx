@@ -100,6 +100,39 @@ class TIASound
   private:
     void polyInit(uInt8* poly, int size, int f0, int f1);
 
+    /**
+      Create samples at an output frequency other than the native 31400Hz,
+      processing both channels one sound clock at a time.
+    */
+    void processResampled(Int16* buffer, uInt32 samples);
+
+    /**
+      Create the given number of samples for a channel into 'level'.  The
+      output only changes when the 'divide by n' counter runs out, so the
+      samples are stored a run at a time.
+
+      @return True if the output didn't change, in which case 'level' is
+              left untouched and the output is the channel's volume
+    */
+    bool processChannel(int chan, Int16* level, uInt32 samples, Int16 audv);
+
+    // Store the given number of samples of a single level into 'level'
+    void fillLevel(Int16* level, uInt32 samples, Int16 v);
+
+    // Store a run of samples with the given channel levels into 'buffer',
+    // and answer the location following them
+    Int16* fill(Int16* buffer, uInt32 length, Int16 v0, Int16 v1);
+
+    // Same as fill(), but with samples which differ for each channel
+    Int16* interleave(Int16* buffer, uInt32 length,
+                      const Int16* level0, const Int16* level1);
+
+    /**
+      Advance the polynomial counters of a channel when its 'divide by n'
+      counter runs out, and answer the channel's new output level.
+    */
+    Int16 clockChannel(int chan, Int16 v, Int16 audv);
+
   private:
     // Definitions for AUDCx (15, 16)
     enum AUDCxRegister
@@ -127,8 +160,9 @@ class TIASound
       POLY5_SIZE = 0x001f,
       POLY9_SIZE = 0x01ff,
       DIV3_MASK  = 0x0c,
-      AUDV_SHIFT = 10     // shift 2 positions for AUDV,
+      AUDV_SHIFT = 10,    // shift 2 positions for AUDV,
                           // then another 8 for 16-bit sound
+      kBlockSize = 256    // samples rendered per block by process()
     };
 
     enum ChannelMode {
@@ -177,6 +211,13 @@ class TIASound
       implemented by using counters.
     */
     static const uInt8 Div31[POLY5_SIZE];
+
+    /*
+      Whether a channel's output is clocked when its 'divide by n' counter
+      runs out, for each AUDC value and (already incremented) P5 position.
+      This folds the Div31 and POLY5 clock modifiers into a single lookup.
+    */
+    bool myClockTick[16][POLY5_SIZE];
 };
 
 #endif
@@ -73,7 +73,27 @@ class Thumbulator
     */
     void run();
 
+    /**
+      Discard any instructions already decoded from the ROM, since it has
+      been modified (ie, patched by the debugger).
+    */
+    void romChanged();
+
   private:
+    // Each Thumb instruction the emulator understands, named as in the
+    // ARM Architecture Reference Manual
+    enum Op {
+      undecoded,
+      invalid,
+      adc, add1, add2, add3, add4, add5, add6, add7, and_, asr1, asr2,
+      b1, b2, bic, bkpt, bl, blx2, bx, cmn, cmp1, cmp2, cmp3, cps, cpy,
+      eor, ldmia, ldr1, ldr2, ldr3, ldr4, ldrb1, ldrb2, ldrh1, ldrh2,
+      ldrsb, ldrsh, lsl1, lsl2, lsr1, lsr2, mov1, mov2, mov3, mul, mvn,
+      neg, orr, pop, push, rev, rev16, revsh, ror, sbc, setend, stmia,
+      str1, str2, str3, strb1, strb2, strh1, strh2, sub1, sub2, sub3, sub4,
+      swi, sxtb, sxth, tst, uxtb, uxth
+    };
+
     uInt32 read_register ( uInt32 reg );
     uInt32 write_register ( uInt32 reg, uInt32 data );
     uInt32 fetch16 ( uInt32 addr );
@@ -91,12 +111,22 @@ class Thumbulator
     void do_cflag_bit ( uInt32 x );
     void do_vflag_bit ( uInt32 x );
 
+    static Op decodeInstruction ( uInt32 inst );
+    Op lookupInstruction ( uInt32 addr, uInt32 inst );
     int execute ( void );
     int reset ( void );
 
   private:
-    const uInt16* rom;
-    uInt16* ram;
+    const uInt8* rom;
+    uInt8* ram;
+
+    // The memory read at each region (top nibble of an address), and the
+    // address bits which must be clear for a read to fall within it
+    const uInt8* readBase[16];
+    uInt32 readInvalid[16];
+
+    // The decoded instruction (an Op) at each halfword of the ROM
+    uInt8 decodedROM[ROMSIZE/2];
 
     uInt32 halfadd;
     uInt32 cpsr;
@@ -105,9 +135,11 @@ class Thumbulator
     uInt32 mamcr;
 
     uInt64 instructions;
+#ifdef THUMB_STATS
     uInt64 fetches;
     uInt64 reads;
     uInt64 writes;
+#endif
 };
 
 #endif
@@ -0,0 +1,1032 @@
+/* Headless batch runner
+ *
+ * Drives the emulation core directly (without a libretro
+ * frontend) in order to measure raw throughput. Each ROM
+ * is run for a fixed number of frames with video output
+ * discarded, and the following is reported:
+ * - frames per second
+ * - 6502 instructions per second
+ * - how many times per frame the TIA had to bring the
+ *   frame buffer up to date with the CPU
+ * - peak resident set size of the process
+ * - when rewinding is enabled, the memory used per
+ *   second of rewind history, and the time taken to
+ *   add each frame to it
+ * - optionally, the time taken to save and load a
+ *   state, both as a regular state (as for netplay)
+ *   and as a snapshot (as for run-ahead)
+ * - optionally, a checksum of the generated audio, so
+ *   that the output of different builds can be compared
+ * - optionally, the throughput of the MD5 used to
+ *   identify the ROM, both for one image and for four
+ *   at a time (as when indexing a collection), after
+ *   checking that hashing in pieces or side by side
+ *   gives the same digests
+ *
+ * Alternatively, with -b, a sequence of frames is
+ * captured from each ROM and every frame blending
+ * function is timed over it, scalar against SIMD,
+ * checking that both produce identical output.
+ *
+ * With -t, no ROMs are run. Instead, small built-in test
+ * programs write the TIA audio registers throughout the
+ * frame, and the checksums of their audio are checked
+ * against reference values, failing on any difference.
+ *
+ * Usage: stella2014_bench [-f frames] [-w warmup] [-n] [-p] [-a] [-o rate] [-r MB] [-s] [-m] [-b] [-c] <rom|dir> ...
+ *        stella2014_bench -t
+ *   -f N   Number of timed frames per ROM (default 3600)
+ *   -w N   Number of untimed warm-up frames (default 60)
+ *   -n     Skip audio processing
+ *   -p     Skip pixel generation (collisions are
+ *          still emulated)
+ *   -a     Print a checksum of the generated audio
+ *   -o N   Resample audio to N Hz, as the core's
+ *          audio output rate option does
+ *   -r N   Enable rewind, with a buffer of N MB
+ *   -s     Measure state save/load times
+ *   -m     Measure and check MD5
+ *   -b     Measure frame blending instead of
+ *          emulation (-f sets the number of
+ *          frames blended)
+ *   -t     Check the audio of built-in test
+ *          programs against reference
+ *          checksums, instead of running ROMs
+ *   -c     Always print CSV (default when more than
+ *          one ROM or a directory is specified)
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include <boolean.h>
+#include <streams/file_stream.h>
+
+#include "Console.hxx"
+#include "Cart.hxx"
+#include "Props.hxx"
+#include "MD5.hxx"
+#include "Sound.hxx"
+#include "Resampler.hxx"
+#include "SerialPort.hxx"
+#include "TIA.hxx"
+#include "Switches.hxx"
+#include "PropsSet.hxx"
+#include "Paddles.hxx"
+#include "M6502.hxx"
+#include "M6532.hxx"
+#include "Version.hxx"
+#include "StateManager.hxx"
+
+#include "Stubs.hxx"
+
+#include "frame_blend.h"
+
+/* Included last, as bspf.hxx unconditionally
+ * defines MIN/MAX */
+#include <retro_dirent.h>
+#include <retro_miscellaneous.h>
+#include <file/file_path.h>
+
+/* Same limit as retro_load_game() */
+#define MAX_ROM_SIZE (96 * 1024)
+
+#define DEFAULT_FRAMES 3600
+#define DEFAULT_WARMUP 60
+
+/* Native TIA sample rate */
+#define TIA_SAMPLE_RATE 31400
+
+/* Number of save/load round trips timed with -s */
+#define STATE_ITERATIONS 10000
+
+/* Number of bytes hashed with -m */
+#define MD5_BYTES (64 * 1024 * 1024)
+
+/* Number of frames each audio test program runs for */
+#define AUDIO_TEST_FRAMES 120
+
+/* Number of consecutive frames captured with -b */
+#define BLEND_FRAMES 64
+
+/* Same size as the core's frame buffers */
+#define BLEND_BUFFER_SIZE (256 * 160 * 4)
+
+static OSystem osystem;
+static StateManager stateManager(&osystem);
+
+static unsigned num_frames   = DEFAULT_FRAMES;
+static unsigned num_warmup   = DEFAULT_WARMUP;
+static bool audio_enabled    = true;
+static bool video_enabled    = true;
+static bool audio_checksum   = false;
+static bool csv_output       = false;
+static unsigned rewind_mb    = 0;
+static bool state_timing     = false;
+static bool md5_timing       = false;
+static bool blend_timing     = false;
+static bool audio_test       = false;
+static unsigned sample_rate  = TIA_SAMPLE_RATE;
+
+static Resampler resampler;
+
+/* Values of the core's frame blending option */
+static const char *blend_names[] = {
+   "disabled", "mix", "ghost_65", "ghost_75", "ghost_85", "ghost_95"
+};
+
+#define NUM_BLEND_METHODS (sizeof(blend_names) / sizeof(blend_names[0]))
+
+struct blend_result
+{
+   const char *method;
+   unsigned pixel_bytes;
+   double scalar_us;
+   double simd_us;
+   bool identical;
+};
+
+struct bench_result
+{
+   string name;
+   string md5;
+   string type;
+   string format;
+   unsigned frames;
+   double seconds;
+   uint64_t instructions;
+   uint64_t frame_updates;
+   long peak_rss_kb;
+   double rewind_seconds;
+   double rewind_kb_per_sec;
+   unsigned state_size;
+   double state_us;
+   double snapshot_us;
+   uint64_t audio_hash;
+   double md5_mb_per_sec;
+   double md5_multi_mb_per_sec;
+   bool md5_identical;
+   std::vector<blend_result> blend;
+};
+
+/* Returns peak resident set size of the process,
+ * in kilobytes (0 if unavailable) */
+static long get_peak_rss_kb(void)
+{
+#ifdef _WIN32
+   return 0;
+#else
+   struct rusage usage;
+   if (getrusage(RUSAGE_SELF, &usage) != 0)
+      return 0;
+#ifdef __APPLE__
+   /* ru_maxrss is reported in bytes on OSX */
+   return (long)(usage.ru_maxrss / 1024);
+#else
+   return (long)usage.ru_maxrss;
+#endif
+#endif
+}
+
+/* Quotes a CSV field if required */
+static string csv_field(const string &field)
+{
+   string quoted = "\"";
+   size_t i;
+
+   if (field.find_first_of(",\"\n") == string::npos)
+      return field;
+
+   for (i = 0; i < field.size(); i++)
+   {
+      if (field[i] == '"')
+         quoted += '"';
+      quoted += field[i];
+   }
+
+   return quoted + "\"";
+}
+
+static string trim(const string &str)
+{
+   size_t first = str.find_first_not_of(' ');
+   size_t last  = str.find_last_not_of(' ');
+
+   if (first == string::npos)
+      return "";
+
+   return str.substr(first, last - first + 1);
+}
+
+/* 64-bit FNV-1a hash of the given samples, continuing
+ * from 'hash' */
+static uint64_t hash_samples(uint64_t hash, const int16_t *samples,
+      size_t count)
+{
+   const uint8_t *bytes = (const uint8_t*)samples;
+   size_t i;
+
+   for (i = 0; i < count * sizeof(int16_t); i++)
+   {
+      hash ^= bytes[i];
+      hash *= 0x100000001b3ULL;
+   }
+
+   return hash;
+}
+
+/* Runs a single frame, mirroring retro_run() minus
+ * input handling and frontend callbacks. Returns
+ * number of 6502 instructions executed; time spent
+ * adding the frame to the rewind history is added
+ * to 'rewind_seconds', and the generated audio to
+ * 'audio_hash' (with -a) */
+static uint64_t run_frame(Console *console, int16_t *sample_buffer,
+      uint32_t samples_per_frame, double &rewind_seconds,
+      uint64_t &audio_hash)
+{
+   M6502& cpu            = console->system().m6502();
+   uInt32 start_count    = (uInt32)cpu.totalInstructionCount();
+
+   /* As in the core, the rewind history holds the state
+    * each frame starts from */
+   if (rewind_mb)
+   {
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      stateManager.update();
+      rewind_seconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+   }
+
+   console->tia().update();
+
+   if (audio_enabled)
+   {
+      static int16_t resampled_buffer[4096];
+      const int16_t *samples = sample_buffer;
+      uint32_t count         = samples_per_frame;
+
+      osystem.sound().processFragment(sample_buffer, samples_per_frame);
+      if (resampler.enabled())
+      {
+         count   = resampler.process(sample_buffer, samples_per_frame,
+               resampled_buffer, sizeof(resampled_buffer) / (2 * sizeof(int16_t)));
+         samples = resampled_buffer;
+      }
+
+      if (audio_checksum)
+         audio_hash = hash_samples(audio_hash, samples, count * 2);
+   }
+
+   return (uInt32)cpu.totalInstructionCount() - start_count;
+}
+
+/* Times saving and loading a state through the
+ * StateManager (without a checksum, as for netplay),
+ * and through a console snapshot (as for run-ahead).
+ * Each state is loaded straight back, so emulation
+ * is unaffected */
+static void bench_states(Console *console, bench_result &result)
+{
+   std::vector<uInt8> buffer;
+   unsigned i;
+
+   Serializer counter(NULL, 0);
+   stateManager.saveState(counter, false);
+   buffer.resize(counter.size());
+
+   result.state_size = counter.size();
+
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+   for (i = 0; i < STATE_ITERATIONS; i++)
+   {
+      Serializer out(&buffer[0], (uInt32)buffer.size());
+      stateManager.saveState(out, false);
+      Serializer in(&buffer[0], (uInt32)buffer.size(), true);
+      stateManager.loadState(in);
+   }
+
+   std::chrono::steady_clock::time_point mid = std::chrono::steady_clock::now();
+
+   for (i = 0; i < STATE_ITERATIONS; i++)
+   {
+      console->saveSnapshot(&buffer[0], (uInt32)buffer.size());
+      console->loadSnapshot(&buffer[0], (uInt32)buffer.size());
+   }
+
+   std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+   result.state_us    = std::chrono::duration<double, std::micro>(
+         mid - start).count() / STATE_ITERATIONS;
+   result.snapshot_us = std::chrono::duration<double, std::micro>(
+         end - mid).count() / STATE_ITERATIONS;
+}
+
+/* Times hashing the ROM image repeatedly, as is done
+ * once when it's loaded; returns MB/sec. Also sets
+ * 'multi_mb_per_sec' to the throughput of hashing four
+ * copies of the image at a time */
+static double bench_md5(const uInt8 *data, uInt32 size,
+      double &multi_mb_per_sec)
+{
+   unsigned iterations = MD5_BYTES / size + 1;
+   const uInt8 *buffers[4] = { data, data, data, data };
+   uInt32 lengths[4]       = { size, size, size, size };
+   string digests[4];
+   string md5;
+   unsigned i;
+
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+   for (i = 0; i < iterations; i++)
+      md5 = MD5(data, size);
+
+   std::chrono::steady_clock::time_point mid = std::chrono::steady_clock::now();
+
+   for (i = 0; i < iterations; i += 4)
+      MD5(buffers, lengths, 4, digests);
+
+   std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+   double seconds       = std::chrono::duration<double>(mid - start).count();
+   double multi_seconds = std::chrono::duration<double>(end - mid).count();
+
+   multi_mb_per_sec = (double)((iterations + 3) & ~3u) * size /
+         (1024.0 * 1024.0) / ((multi_seconds > 0.0) ? multi_seconds : 1e-9);
+
+   return (double)iterations * size / (1024.0 * 1024.0) /
+         ((seconds > 0.0) ? seconds : 1e-9);
+}
+
+/* Checks that hashing the ROM image in pieces of various
+ * sizes through MD5Context, and hashing parts of it side
+ * by side through the multi-buffer MD5, gives the same
+ * digests as hashing each message whole */
+static bool check_md5(const uInt8 *data, uInt32 size)
+{
+   static const uInt32 piece_sizes[] = { 1, 3, 55, 63, 64, 65, 1000 };
+   string md5 = MD5(data, size);
+   MD5Context context;
+   size_t i;
+
+   for (i = 0; i < sizeof(piece_sizes) / sizeof(piece_sizes[0]); i++)
+   {
+      uInt32 offset;
+
+      for (offset = 0; offset < size; offset += piece_sizes[i])
+         context.update(data + offset,
+               std::min(piece_sizes[i], size - offset));
+
+      if (context.result() != md5)
+         return false;
+   }
+
+   /* Messages of different lengths and alignments, so that
+    * each is finished after a different number of blocks
+    * hashed side by side; the last two don't fill a group
+    * of four and are hashed on their own */
+   const uInt8 *buffers[6] = {
+      data, data + 1, data + size / 3, data, data + std::min(size, 7u), data
+   };
+   uInt32 lengths[6] = {
+      size, size - 1, size / 2, std::min(size, 64u),
+      std::min(size, 62u) - std::min(size, 7u), 0
+   };
+   string digests[6];
+
+   MD5(buffers, lengths, 6, digests);
+
+   for (i = 0; i < 6; i++)
+      if (digests[i] != MD5(buffers[i], lengths[i]))
+         return false;
+
+   return true;
+}
+
+/* Blends 'count' frames, cycling through the 'num_frames'
+ * frames captured in 'frames', into 'out'/'prev'; returns
+ * microseconds per frame */
+static double time_blend(frame_blend_t blend, const uInt8 *frames,
+      unsigned num_frames, const uint32_t *palette, int width, int height,
+      unsigned count, uint8_t *out, uint8_t *prev)
+{
+   size_t frame_size = (size_t)width * height;
+   unsigned i;
+
+   memset(prev, 0, BLEND_BUFFER_SIZE);
+
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+   for (i = 0; i < count; i++)
+      blend(frames + (i % num_frames) * frame_size, palette, out, prev,
+            width, height);
+
+   return std::chrono::duration<double, std::micro>(
+         std::chrono::steady_clock::now() - start).count() / count;
+}
+
+/* Blends every captured frame with both functions,
+ * returning false as soon as the output or the
+ * retained previous frame differs */
+static bool compare_blend(frame_blend_t scalar, frame_blend_t simd,
+      const uInt8 *frames, unsigned num_frames, size_t frame_size,
+      const uint32_t *palette, int width, int height, unsigned pixel_bytes)
+{
+   static uint8_t out_a[BLEND_BUFFER_SIZE], prev_a[BLEND_BUFFER_SIZE];
+   static uint8_t out_b[BLEND_BUFFER_SIZE], prev_b[BLEND_BUFFER_SIZE];
+   size_t bytes = (size_t)width * height * pixel_bytes;
+   unsigned i;
+
+   memset(prev_a, 0, sizeof(prev_a));
+   memset(prev_b, 0, sizeof(prev_b));
+
+   for (i = 0; i < num_frames; i++)
+   {
+      scalar(frames + i * frame_size, palette, out_a, prev_a, width, height);
+      simd(frames + i * frame_size, palette, out_b, prev_b, width, height);
+
+      if (memcmp(out_a, out_b, bytes) || memcmp(prev_a, prev_b, bytes))
+         return false;
+   }
+
+   return true;
+}
+
+/* Captures BLEND_FRAMES frames and times every blending
+ * function over them. The SIMD functions are checked
+ * against the scalar ones both at the captured size and
+ * with an odd pixel count, which exercises the path for
+ * frames that aren't a whole number of SIMD blocks */
+static void bench_blend(Console *console, int16_t *sample_buffer,
+      uint32_t samples_per_frame, bench_result &result)
+{
+   static uint8_t out[BLEND_BUFFER_SIZE], prev[BLEND_BUFFER_SIZE];
+   TIA& tia                = console->tia();
+   const uint32_t *palette = console->getPalette(0);
+   std::vector<uInt8> frames;
+   double rewind_seconds   = 0.0;
+   uint64_t audio_hash     = 0;
+   int width, height;
+   size_t frame_size;
+   unsigned pixel_bytes;
+   unsigned i;
+
+   tia.enableRendering(true);
+
+   width      = tia.width();
+   height     = tia.height();
+   frame_size = (size_t)width * height;
+   frames.resize(frame_size * BLEND_FRAMES);
+
+   for (i = 0; i < BLEND_FRAMES; i++)
+   {
+      run_frame(console, sample_buffer, samples_per_frame, rewind_seconds,
+            audio_hash);
+      memcpy(&frames[i * frame_size], tia.currentFrameBuffer(), frame_size);
+   }
+
+   for (pixel_bytes = 2; pixel_bytes <= 4; pixel_bytes += 2)
+   {
+      for (i = 0; i < NUM_BLEND_METHODS; i++)
+      {
+         enum frame_blend_method method = (enum frame_blend_method)i;
+         frame_blend_t scalar = frame_blend_get(method, pixel_bytes, false);
+         frame_blend_t simd   = frame_blend_get(method, pixel_bytes, true);
+         blend_result blend;
+
+         blend.method      = blend_names[i];
+         blend.pixel_bytes = pixel_bytes;
+         blend.scalar_us   = time_blend(scalar, &frames[0], BLEND_FRAMES,
+               palette, width, height, num_frames, out, prev);
+         blend.simd_us     = 0.0;
+         blend.identical   = true;
+
+         if (frame_blend_simd_flag())
+         {
+            blend.simd_us   = time_blend(simd, &frames[0], BLEND_FRAMES,
+                  palette, width, height, num_frames, out, prev);
+            blend.identical =
+                  compare_blend(scalar, simd, &frames[0], BLEND_FRAMES,
+                        frame_size, palette, width, height, pixel_bytes) &&
+                  compare_blend(scalar, simd, &frames[0], BLEND_FRAMES,
+                        frame_size, palette, width - 1, height | 1, pixel_bytes);
+         }
+
+         result.blend.push_back(blend);
+      }
+   }
+}
+
+/* Runs the ROM image 'data' as set up by the options,
+ * reporting it as 'name' */
+static bool bench_image(const char *name, const uInt8 *data, uInt32 size,
+      bench_result &result)
+{
+   static int16_t sample_buffer[2048];
+   Settings *settings;
+   Cartridge *cartridge;
+   Console *console;
+   uint32_t samples_per_frame;
+   double rewind_seconds = 0.0;
+   uint64_t audio_hash   = 0xcbf29ce484222325ULL;
+   unsigned i;
+
+   /* Get the game properties */
+   string cartMD5 = MD5(data, size);
+   result.md5_mb_per_sec       = 0.0;
+   result.md5_multi_mb_per_sec = 0.0;
+   result.md5_identical        = true;
+   if (md5_timing)
+   {
+      result.md5_identical  = check_md5(data, size);
+      result.md5_mb_per_sec = bench_md5(data, size,
+            result.md5_multi_mb_per_sec);
+   }
+   Properties props;
+   osystem.propSet().getMD5(cartMD5, props);
+
+   /* Load the cart */
+   string cartType = props.get(Cartridge_Type);
+   string cartId;
+   settings = new Settings(&osystem);
+   settings->setValue(Settings::RomLoadCount, false);
+   cartridge = Cartridge::create(data, size, cartMD5, cartType, cartId, osystem, *settings);
+
+   if (cartridge == 0)
+   {
+      fprintf(stderr, "%s: failed to load cartridge\n", name);
+      delete settings;
+      return false;
+   }
+
+   /* Create the console */
+   console = new Console(&osystem, cartridge, props);
+   osystem.myConsole = console;
+
+   console->initializeVideo();
+   console->initializeAudio();
+   console->tia().enableRendering(video_enabled);
+
+   stateManager.reset();
+   stateManager.rewindManager().setBufferSize(rewind_mb << 20);
+
+   samples_per_frame = (uint32_t)((float)TIA_SAMPLE_RATE / console->getFramerate());
+   resampler.setRates(TIA_SAMPLE_RATE, sample_rate);
+
+   for (i = 0; i < num_warmup; i++)
+      run_frame(console, sample_buffer, samples_per_frame, rewind_seconds,
+            audio_hash);
+
+   result.name         = name;
+   result.md5          = cartMD5;
+   result.type         = trim(console->about().BankSwitch);
+   result.format       = trim(console->about().DisplayFormat);
+   result.frames       = num_frames;
+   result.instructions = 0;
+
+   if (blend_timing)
+   {
+      bench_blend(console, sample_buffer, samples_per_frame, result);
+
+      stateManager.reset();
+
+      delete console;
+      osystem.myConsole = 0;
+      delete settings;
+
+      return true;
+   }
+
+   uInt32 start_updates = console->tia().frameUpdateCount();
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+   rewind_seconds = 0.0;
+
+   for (i = 0; i < num_frames; i++)
+      result.instructions += run_frame(console, sample_buffer,
+            samples_per_frame, rewind_seconds, audio_hash);
+
+   std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+   result.frame_updates = console->tia().frameUpdateCount() - start_updates;
+
+   result.seconds           = std::chrono::duration<double>(end - start).count();
+   result.peak_rss_kb       = get_peak_rss_kb();
+   result.rewind_seconds    = rewind_seconds;
+   result.rewind_kb_per_sec = 0.0;
+   result.state_size        = 0;
+   result.state_us          = 0.0;
+   result.snapshot_us       = 0.0;
+   result.audio_hash        = audio_hash;
+
+   /* Memory used per second of emulated time
+    * held in the rewind history */
+   if (stateManager.rewindManager().numStates() > 0)
+      result.rewind_kb_per_sec =
+            (stateManager.rewindManager().bytesUsed() / 1024.0) *
+            console->getFramerate() /
+            stateManager.rewindManager().numStates();
+
+   if (state_timing)
+      bench_states(console, result);
+
+   stateManager.reset();
+
+   delete console;
+   osystem.myConsole = 0;
+   delete settings;
+
+   return true;
+}
+
+static bool bench_rom(const char *path, bench_result &result)
+{
+   void *data   = NULL;
+   int64_t size = 0;
+   bool ok;
+
+   if (!filestream_read_file(path, &data, &size) || !data)
+   {
+      fprintf(stderr, "%s: failed to read file\n", path);
+      return false;
+   }
+
+   if (size <= 0 || size >= MAX_ROM_SIZE)
+   {
+      fprintf(stderr, "%s: invalid ROM size (%lld bytes)\n", path, (long long)size);
+      free(data);
+      return false;
+   }
+
+   ok = bench_image(path_basename(path), (const uInt8*)data, (uInt32)size,
+         result);
+   free(data);
+
+   return ok;
+}
+
+/* Builds the 4K image of a program which writes the
+ * scanline counter to AUDV0 and AUDF0 at the start of
+ * every scanline, and to AUDV1 and AUDC1 around its
+ * middle and end, so that writes fall at every phase
+ * of the TIA sample clock. Each frame has 3 lines of
+ * VSYNC and '2 * blocks' lines of audio writes */
+static void build_audio_test(uInt8 *rom, uInt8 blocks)
+{
+   static const uInt8 start[] = {
+      0x78,             /*        SEI                  */
+      0xd8,             /*        CLD                  */
+      0xa2, 0x00,       /*        LDX #0               */
+      0x8a,             /*        TXA                  */
+      0x95, 0x00,       /* clear: STA $00,X            */
+      0xca,             /*        DEX                  */
+      0xd0, 0xfb,       /*        BNE clear            */
+      0xa9, 0x04,       /*        LDA #4               */
+      0x85, 0x15,       /*        STA AUDC0            */
+      0xa9, 0x08,       /*        LDA #8               */
+      0x85, 0x16,       /*        STA AUDC1            */
+      0xa9, 0x1f,       /*        LDA #31              */
+      0x85, 0x18,       /*        STA AUDF1            */
+      0xa9, 0x02,       /* frame: LDA #2               */
+      0x85, 0x00,       /*        STA VSYNC            */
+      0x85, 0x02,       /*        STA WSYNC            */
+      0x85, 0x02,       /*        STA WSYNC            */
+      0x85, 0x02,       /*        STA WSYNC            */
+      0xa9, 0x00,       /*        LDA #0               */
+      0x85, 0x00,       /*        STA VSYNC            */
+      0xa0, 0x02,       /*        LDY #2               */
+      0xa2, 0x00,       /* block: LDX #blocks          */
+      0x85, 0x02,       /* line:  STA WSYNC            */
+      0x86, 0x19,       /*        STX AUDV0            */
+      0x86, 0x17        /*        STX AUDF0            */
+   };
+   static const uInt8 end[] = {
+      0xca,             /*        DEX                  */
+      0xd0, 0xdb,       /*        BNE line             */
+      0x88,             /*        DEY                  */
+      0xd0, 0xd6,       /*        BNE block            */
+      0x4c, 0x16, 0xf0  /*        JMP frame            */
+   };
+   uInt8 *pc = rom;
+
+   memset(rom, 0xea, 4096);
+
+   memcpy(pc, start, sizeof(start));
+   rom[0x27] = blocks;  /* operand of LDX #blocks */
+   pc += sizeof(start);
+
+   pc += 14;            /*        NOP x 14             */
+   *pc++ = 0x86;        /*        STX AUDV1            */
+   *pc++ = 0x1a;
+   pc += 10;            /*        NOP x 10             */
+   *pc++ = 0x86;        /*        STX AUDC1            */
+   *pc++ = 0x16;
+
+   memcpy(pc, end, sizeof(end));
+
+   /* Reset and IRQ vectors */
+   rom[0xffc] = 0x00;
+   rom[0xffd] = 0xf0;
+   rom[0xffe] = 0x00;
+   rom[0xfff] = 0xf0;
+}
+
+/* Runs each audio test program for AUDIO_TEST_FRAMES
+ * frames at the TIA sample rate, and compares the
+ * checksum of its audio with the one recorded when
+ * writes were first timed by CPU cycle. 'ntsc' has all
+ * writes of a frame within its fragment, 'overrun' has
+ * frames running past the end of the fragment (whose
+ * last writes take effect at its end) and 'pal' runs at
+ * 50 Hz. Returns the number of mismatches */
+static int run_audio_test(void)
+{
+   static const struct
+   {
+      const char *name;
+      uInt8 blocks;
+      uint64_t audio_hash;
+   } tests[] = {
+      { "ntsc",    129, 0x60e6ccc89c7c7d05ULL },
+      { "overrun", 140, 0x617d78f2798587c5ULL },
+      { "pal",     155, 0x895e6c3fa45a69e5ULL }
+   };
+   static uInt8 rom[4096];
+   int failed = 0;
+   size_t i;
+
+   num_frames     = AUDIO_TEST_FRAMES;
+   num_warmup     = 0;
+   audio_enabled  = true;
+   audio_checksum = true;
+   sample_rate    = TIA_SAMPLE_RATE;
+   rewind_mb      = 0;
+   md5_timing     = false;
+   blend_timing   = false;
+
+   for (i = 0; i < sizeof(tests) / sizeof(tests[0]); i++)
+   {
+      bench_result result;
+      bool ok;
+
+      result.audio_hash = 0;
+      build_audio_test(rom, tests[i].blocks);
+
+      ok = bench_image(tests[i].name, rom, sizeof(rom), result) &&
+            result.audio_hash == tests[i].audio_hash;
+      if (!ok)
+         failed++;
+
+      printf("%-8s %016llx %s\n", tests[i].name,
+            (unsigned long long)result.audio_hash,
+            ok ? "ok" : "** AUDIO DIFFERS **");
+   }
+
+   return failed;
+}
+
+static void print_blend_result(const bench_result &result)
+{
+   size_t i;
+
+   if (!csv_output)
+   {
+      printf("ROM:          %s\n", result.name.c_str());
+      printf("MD5:          %s\n", result.md5.c_str());
+   }
+
+   for (i = 0; i < result.blend.size(); i++)
+   {
+      const blend_result &blend = result.blend[i];
+
+      if (csv_output)
+         printf("%s,%s,%s,%u,%.3f,%.3f,%d\n",
+               csv_field(result.name).c_str(), result.md5.c_str(),
+               blend.method, blend.pixel_bytes * 8,
+               blend.scalar_us, blend.simd_us, blend.identical ? 1 : 0);
+      else if (frame_blend_simd_flag())
+         printf("%-8s %2ubpp: %8.3f us scalar, %8.3f us SIMD%s\n",
+               blend.method, blend.pixel_bytes * 8,
+               blend.scalar_us, blend.simd_us,
+               blend.identical ? "" : "  ** OUTPUT DIFFERS **");
+      else
+         printf("%-8s %2ubpp: %8.3f us scalar\n",
+               blend.method, blend.pixel_bytes * 8, blend.scalar_us);
+   }
+
+   fflush(stdout);
+}
+
+static void print_result(const bench_result &result)
+{
+   double seconds = (result.seconds > 0.0) ? result.seconds : 1e-9;
+
+   if (blend_timing)
+   {
+      print_blend_result(result);
+      return;
+   }
+
+   if (csv_output)
+   {
+      printf("%s,%s,%s,%s,%u,%.6f,%.2f,%llu,%.0f,%.1f,%ld,%.2f,%.3f,%u,%.3f,%.3f,%016llx,%.1f,%.1f,%d\n",
+            csv_field(result.name).c_str(), result.md5.c_str(),
+            csv_field(result.type).c_str(), csv_field(result.format).c_str(),
+            result.frames, result.seconds,
+            result.frames / seconds,
+            (unsigned long long)result.instructions,
+            result.instructions / seconds,
+            (double)result.frame_updates / result.frames,
+            result.peak_rss_kb,
+            result.rewind_kb_per_sec,
+            result.rewind_seconds * 1e6 / result.frames,
+            result.state_size, result.state_us, result.snapshot_us,
+            audio_checksum ? (unsigned long long)result.audio_hash : 0ULL,
+            result.md5_mb_per_sec, result.md5_multi_mb_per_sec,
+            result.md5_identical ? 1 : 0);
+   }
+   else
+   {
+      printf("ROM:          %s\n", result.name.c_str());
+      printf("MD5:          %s\n", result.md5.c_str());
+      printf("Type:         %s\n", result.type.c_str());
+      printf("Frames:       %u in %.3f s\n", result.frames, result.seconds);
+      printf("Frames/sec:   %.2f\n", result.frames / seconds);
+      printf("Instructions: %llu\n", (unsigned long long)result.instructions);
+      printf("Instr/sec:    %.0f\n", result.instructions / seconds);
+      printf("TIA updates:  %.1f/frame\n",
+            (double)result.frame_updates / result.frames);
+      printf("Peak RSS:     %ld KB\n", result.peak_rss_kb);
+      if (rewind_mb)
+      {
+         printf("Rewind:       %.2f KB/sec of history\n", result.rewind_kb_per_sec);
+         printf("Rewind cost:  %.3f us/frame\n",
+               result.rewind_seconds * 1e6 / result.frames);
+      }
+      if (state_timing)
+      {
+         printf("State size:   %u bytes\n", result.state_size);
+         printf("State:        %.3f us/save+load\n", result.state_us);
+         printf("Snapshot:     %.3f us/save+load\n", result.snapshot_us);
+      }
+      if (audio_checksum)
+         printf("Audio hash:   %016llx\n", (unsigned long long)result.audio_hash);
+      if (md5_timing)
+         printf("MD5:          %.1f MB/sec, %.1f MB/sec four at a time%s\n",
+               result.md5_mb_per_sec, result.md5_multi_mb_per_sec,
+               result.md5_identical ? "" : "  ** DIGESTS DIFFER **");
+   }
+
+   fflush(stdout);
+}
+
+/* Appends all regular files in 'dir' to 'paths',
+ * sorted by name for reproducible output */
+static void collect_dir(const char *dir, std::vector<string> &paths)
+{
+   std::vector<string> entries;
+   struct RDIR *rdir = retro_opendir(dir);
+   char path[PATH_MAX_LENGTH];
+
+   if (!rdir)
+   {
+      fprintf(stderr, "%s: failed to open directory\n", dir);
+      return;
+   }
+
+   while (retro_readdir(rdir))
+   {
+      const char *name = retro_dirent_get_name(rdir);
+
+      if (retro_dirent_is_dir(rdir, NULL))
+         continue;
+
+      fill_pathname_join(path, dir, name, sizeof(path));
+      entries.push_back(path);
+   }
+
+   retro_closedir(rdir);
+
+   std::sort(entries.begin(), entries.end());
+   paths.insert(paths.end(), entries.begin(), entries.end());
+}
+
+static void print_usage(const char *argv0)
+{
+   fprintf(stderr,
+         "Usage: %s [-f frames] [-w warmup] [-n] [-p] [-a] [-o rate] [-r MB] [-s] [-m] [-b] [-c] <rom|dir> ...\n"
+         "       %s -t\n"
+         "  -f N   Number of timed frames per ROM (default %u)\n"
+         "  -w N   Number of untimed warm-up frames (default %u)\n"
+         "  -n     Skip audio processing\n"
+         "  -p     Skip pixel generation\n"
+         "  -a     Print a checksum of the generated audio\n"
+         "  -o N   Resample audio to N Hz\n"
+         "  -r N   Enable rewind, with a buffer of N MB\n"
+         "  -s     Measure state save/load times\n"
+         "  -m     Measure and check MD5\n"
+         "  -b     Measure frame blending instead of emulation\n"
+         "  -t     Check audio against reference checksums\n"
+         "  -c     Always print CSV\n",
+         argv0, argv0, DEFAULT_FRAMES, DEFAULT_WARMUP);
+}
+
+int main(int argc, char *argv[])
+{
+   std::vector<string> paths;
+   bool have_dir = false;
+   int failed    = 0;
+   size_t i, j;
+   int arg;
+
+   for (arg = 1; arg < argc; arg++)
+   {
+      if (!strcmp(argv[arg], "-f") && arg + 1 < argc)
+         num_frames = (unsigned)strtoul(argv[++arg], NULL, 10);
+      else if (!strcmp(argv[arg], "-w") && arg + 1 < argc)
+         num_warmup = (unsigned)strtoul(argv[++arg], NULL, 10);
+      else if (!strcmp(argv[arg], "-n"))
+         audio_enabled = false;
+      else if (!strcmp(argv[arg], "-p"))
+         video_enabled = false;
+      else if (!strcmp(argv[arg], "-a"))
+         audio_checksum = true;
+      else if (!strcmp(argv[arg], "-o") && arg + 1 < argc)
+         sample_rate = (unsigned)strtoul(argv[++arg], NULL, 10);
+      else if (!strcmp(argv[arg], "-r") && arg + 1 < argc)
+         rewind_mb = (unsigned)strtoul(argv[++arg], NULL, 10);
+      else if (!strcmp(argv[arg], "-s"))
+         state_timing = true;
+      else if (!strcmp(argv[arg], "-m"))
+         md5_timing = true;
+      else if (!strcmp(argv[arg], "-b"))
+         blend_timing = true;
+      else if (!strcmp(argv[arg], "-t"))
+         audio_test = true;
+      else if (!strcmp(argv[arg], "-c"))
+         csv_output = true;
+      else if (argv[arg][0] == '-')
+      {
+         print_usage(argv[0]);
+         return 1;
+      }
+      else if (path_is_directory(argv[arg]))
+      {
+         collect_dir(argv[arg], paths);
+         have_dir = true;
+      }
+      else
+         paths.push_back(argv[arg]);
+   }
+
+   if (audio_test)
+      return run_audio_test() ? 2 : 0;
+
+   if (paths.empty() || num_frames == 0 || sample_rate == 0)
+   {
+      print_usage(argv[0]);
+      return 1;
+   }
+
+   if (have_dir || paths.size() > 1)
+      csv_output = true;
+
+   if (csv_output && blend_timing)
+      printf("rom,md5,blend,bpp,scalar_us,simd_us,identical\n");
+   else if (csv_output)
+      printf("rom,md5,type,format,frames,seconds,fps,instructions,ips,tia_updates_per_frame,peak_rss_kb,"
+            "rewind_kb_per_sec,rewind_us_per_frame,state_size,state_us,snapshot_us,audio_hash,md5_mb_per_sec,"
+            "md5x4_mb_per_sec,md5_identical\n");
+
+   for (i = 0; i < paths.size(); i++)
+   {
+      bench_result result;
+
+      if (!bench_rom(paths[i].c_str(), result))
+      {
+         failed++;
+         continue;
+      }
+
+      print_result(result);
+
+      if (!result.md5_identical)
+         failed++;
+
+      for (j = 0; j < result.blend.size(); j++)
+         if (!result.blend[j].identical)
+            failed++;
+   }
+
+   return failed ? 2 : 0;
+}
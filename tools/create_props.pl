@@ -0,0 +1,159 @@
+#!/usr/bin/perl
+#
+# Generates DefProps.hxx (the built-in properties database) from a
+# Stella properties file:
+#
+#   perl tools/create_props.pl stella/src/emucore/stella.pro \
+#        > stella/src/emucore/DefProps.hxx
+#
+# Entries are sorted by MD5, which is written in binary as its high and
+# low 64 bits, so that PropertiesSet can binary search them.  Every
+# distinct property value is stored once in a single string pool, and
+# each entry holds offsets into it (offset 0 being the empty string,
+# meaning the property takes its default value).
+
+use strict;
+use warnings;
+
+# Must be in the same order as PropertyType in Props.hxx
+my @prop_names = (
+  "Cartridge.MD5",
+  "Cartridge.Manufacturer",
+  "Cartridge.ModelNo",
+  "Cartridge.Name",
+  "Cartridge.Note",
+  "Cartridge.Rarity",
+  "Cartridge.Sound",
+  "Cartridge.Type",
+  "Console.LeftDifficulty",
+  "Console.RightDifficulty",
+  "Console.TelevisionType",
+  "Console.SwapPorts",
+  "Controller.Left",
+  "Controller.Right",
+  "Controller.SwapPaddles",
+  "Controller.MouseAxis",
+  "Display.Format",
+  "Display.YStart",
+  "Display.Height",
+  "Display.Phosphor",
+  "Display.PPBlend"
+);
+
+my %prop_index;
+@prop_index{@prop_names} = (0 .. $#prop_names);
+
+die "usage: $0 stella.pro > DefProps.hxx\n" if @ARGV != 1;
+
+# Read all entries; each is a list of "key" "value" lines,
+# terminated by an empty string
+my @entries = ();
+my @current = ("") x @prop_names;
+my $have_entry = 0;
+
+open(my $in, "<", $ARGV[0]) or die "$ARGV[0]: $!\n";
+while (my $line = <$in>)
+{
+  if ($line =~ /^\s*"([^"]*)"\s+"([^"]*)"/)
+  {
+    die "$ARGV[0]:$.: unknown property '$1'\n" if !exists $prop_index{$1};
+    $current[$prop_index{$1}] = $2;
+    $have_entry = 1;
+  }
+  elsif ($line =~ /^\s*""/)
+  {
+    die "$ARGV[0]:$.: entry without an MD5\n" if $current[0] eq "";
+    push(@entries, [ @current ]) if $have_entry;
+    @current = ("") x @prop_names;
+    $have_entry = 0;
+  }
+}
+close($in);
+
+die "$ARGV[0]: unterminated entry at end of file\n" if $have_entry;
+
+# Sort by MD5; lowercase hex strings of equal length compare
+# in the same order as the numbers they represent
+my %seen = ();
+foreach my $entry (@entries)
+{
+  $entry->[0] = lc($entry->[0]);
+  die "$ARGV[0]: malformed MD5 '$entry->[0]'\n" if $entry->[0] !~ /^[0-9a-f]{32}$/;
+  die "$ARGV[0]: duplicate MD5 '$entry->[0]'\n" if $seen{$entry->[0]}++;
+}
+@entries = sort { $a->[0] cmp $b->[0] } @entries;
+
+# Build the string pool, in order of first use
+my %offsets = ("" => 0);
+my @strings = ("");
+my $pool_size = 1;
+foreach my $entry (@entries)
+{
+  foreach my $value (@{$entry}[1 .. $#prop_names])
+  {
+    next if exists $offsets{$value};
+    $offsets{$value} = $pool_size;
+    push(@strings, $value);
+    $pool_size += length($value) + 1;
+  }
+}
+
+my $count = @entries;
+my $columns = @prop_names;
+my $offset_type = ($pool_size < 65536) ? "uInt16" : "uInt32";
+
+print <<'EOF';
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id: DefProps.hxx 2839 2014-01-19 19:41:27Z stephena $
+//============================================================================
+
+#ifndef DEF_PROPS_HXX
+#define DEF_PROPS_HXX
+
+/**
+  This code is generated using the 'create_props.pl' script, located in
+  the tools directory.  All properties changes should be made in
+  stella.pro (in this directory), and then this file should be
+  regenerated and the application recompiled:
+
+    perl tools/create_props.pl stella/src/emucore/stella.pro \
+         > stella/src/emucore/DefProps.hxx
+
+  Entries are sorted by MD5, which is stored in binary as its high and
+  low 64 bits in DefPropsMD5.  The remaining properties of each entry
+  are offsets into DefPropsStrings, where every distinct value is stored
+  once (offset 0 is the empty string); the MD5 column itself is unused.
+*/
+
+EOF
+
+print "#define DEF_PROPS_SIZE $count\n\n";
+
+print "static const uInt64 DefPropsMD5[DEF_PROPS_SIZE][2] = {\n";
+print join(",\n", map { "  { 0x" . substr($_->[0], 0, 16) . "ULL, 0x" .
+                        substr($_->[0], 16, 16) . "ULL }" } @entries);
+print "\n};\n\n";
+
+print "static const char DefPropsStrings[] =\n";
+print join("\n", map { "  \"$_\\0\"" } @strings);
+print ";\n\n";
+
+print "static const $offset_type DefProps[DEF_PROPS_SIZE][$columns] = {\n";
+print join(",\n", map { "  { 0, " . join(", ", map { $offsets{$_} }
+                        @{$_}[1 .. $#prop_names]) . " }" } @entries);
+print "\n};\n\n#endif\n";